@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace Benchmarks {
+
+    // Runs the function iterations times and prints the average duration of one run
+    inline double measure(const std::string& name, int iterations, const std::function<void()>& function) {
+        // Warms up caches and allocators so the first run doesn't skew the average
+        function();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            function();
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        const double average_micros = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+        printf("%-40s %12.2f us/op (%d runs)\n", name.c_str(), average_micros, iterations);
+
+        return average_micros;
+    }
+
+}  // namespace Benchmarks
@@ -0,0 +1,14 @@
+#
+# Set benchmarks that need to be built, each one is built from <name>.cpp
+#
+set(BENCHMARK_NAMES
+    MessagePackBenchmark
+)
+
+# Mongo benchmarks need the driver, the pool benchmark also a running mongod
+if (VORTEX_ENABLE_FEATURE_MONGO)
+    list(APPEND BENCHMARK_NAMES
+        MongoPoolBenchmark
+        BsonConversionBenchmark
+    )
+endif()
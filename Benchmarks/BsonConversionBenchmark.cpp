@@ -0,0 +1,58 @@
+#include <Benchmark.h>
+#include <cstdio>
+#include <string>
+#include <bsoncxx/json.hpp>
+#include <Maze/Maze.hpp>
+#include <Core/Storage/Mongo/Bson.h>
+
+using namespace Vortex::Core::Storage;
+
+namespace {
+
+    // Resembles a controller document as the runtime loads it for every request
+    Maze::Element make_controller(int script_length) {
+        Maze::Element document(Maze::Type::Object);
+        document.set("_id", Maze::Element({ "$oid" }, { Maze::Element("5f1e9a3c2b7d4e0012345678") }));
+        document.set("app_id", Maze::Element({ "$oid" }, { Maze::Element("5f1e9a3c2b7d4e0012345679") }));
+        document.set("path", "/api/v1/items/list");
+        document.set("method", "GET");
+        document.set("script_type", "javascript");
+        document.set("script", std::string(script_length, 'x'));
+        document.set("post_script", std::string(script_length / 4, 'y'));
+        document.set("enabled", true);
+        document.set("priority", 10);
+        document.set("timeout", 2.5);
+        document.set("config", Maze::Element({ "cache", "roles" }, { Maze::Element(true), Maze::Element("admin,user") }));
+
+        return document;
+    }
+
+}  // namespace
+
+int main(int argc, char** args) {
+    for (int script_length : { 64, 4096, 65536 }) {
+        const Maze::Element controller = make_controller(script_length);
+        const bsoncxx::document::value bson = Mongo::element_to_bson(controller);
+        const int iterations = script_length >= 65536 ? 1000 : 10000;
+
+        printf("\nController with a %d byte script, bson %zu bytes\n", script_length, (size_t)bson.view().length());
+
+        // Json path is what the conversion was before: bson -> extended json text -> Maze and back
+        const double json_read = Benchmarks::measure("bson to element (json)", iterations, [&bson]() {
+            Maze::Element::from_json(bsoncxx::to_json(bson.view()));
+            });
+        const double direct_read = Benchmarks::measure("bson to element (direct)", iterations, [&bson]() {
+            Mongo::bson_to_element(bson.view());
+            });
+        const double json_write = Benchmarks::measure("element to bson (json)", iterations, [&controller]() {
+            bsoncxx::from_json(controller.to_json(0));
+            });
+        const double direct_write = Benchmarks::measure("element to bson (direct)", iterations, [&controller]() {
+            Mongo::element_to_bson(controller);
+            });
+
+        printf("read speedup %.2fx, write speedup %.2fx\n", json_read / direct_read, json_write / direct_write);
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <Benchmark.h>
+#include <cstdio>
+#include <string>
+#include <Maze/Maze.hpp>
+#include <Core/Util/MessagePack.h>
+
+using namespace Vortex::Core::Util;
+
+namespace {
+
+    // Resembles a filesystem collection of controllers, the largest structured values the cache stores
+    Maze::Element make_collection(int count) {
+        Maze::Element collection(Maze::Type::Array);
+
+        for (int i = 0; i < count; ++i) {
+            Maze::Element document(Maze::Type::Object);
+            document.set("_id", Maze::Element({ "$oid" }, { std::string("5f1e9a3c2b7d4e0012") + std::to_string(100000 + i) }));
+            document.set("name", "controller_" + std::to_string(i));
+            document.set("method", i % 2 == 0 ? "GET" : "POST");
+            document.set("app_id", "5f1e9a3c2b7d4e0012345678");
+            document.set("enabled", true);
+            document.set("priority", i);
+            document.set("weight", i * 0.5);
+            document.set("script", std::string(512, 'x'));
+            document.set("config", Maze::Element({ "cache", "timeout" }, { Maze::Element(true), Maze::Element(30) }));
+
+            collection.push_back(document);
+        }
+
+        return collection;
+    }
+
+}  // namespace
+
+int main(int argc, char** args) {
+    for (int count : { 10, 1000, 10000 }) {
+        const Maze::Element collection = make_collection(count);
+        const int iterations = count >= 10000 ? 10 : (count >= 1000 ? 100 : 10000);
+
+        const std::string json = collection.to_json(0);
+        const std::string packed = MessagePack::encode(collection);
+
+        printf("\n%d documents, json %zu bytes, msgpack %zu bytes\n", count, json.size(), packed.size());
+
+        Benchmarks::measure("json encode", iterations, [&collection]() { collection.to_json(0); });
+        Benchmarks::measure("msgpack encode", iterations, [&collection]() { MessagePack::encode(collection); });
+        const double json_decode = Benchmarks::measure("json decode", iterations, [&json]() { Maze::Element::from_json(json); });
+        const double packed_decode = Benchmarks::measure("msgpack decode", iterations, [&packed]() { MessagePack::decode(packed); });
+
+        printf("decode speedup %.2fx\n", json_decode / packed_decode);
+    }
+
+    return 0;
+}
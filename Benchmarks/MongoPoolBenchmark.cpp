@@ -0,0 +1,77 @@
+#include <Benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Maze/Maze.hpp>
+#include <Core/Storage/Mongo/Mongo.h>
+
+using namespace Vortex::Core::Storage;
+
+namespace {
+
+    const int document_count = 1000;
+    const int queries_per_thread = 200;
+
+}  // namespace
+
+// Runs against a local mongod, e.g. VORTEX_BENCHMARK_MONGO=localhost:27017
+int main(int argc, char** args) {
+    const char* server = std::getenv("VORTEX_BENCHMARK_MONGO");
+    if (server == nullptr || *server == '\0') {
+        printf("VORTEX_BENCHMARK_MONGO is not set, skipping\n");
+
+        return 0;
+    }
+
+    const std::string address = server;
+    const size_t separator = address.find(':');
+
+    Maze::Element mongo_config({ "enabled", "host", "database" }, {
+        Maze::Element(true), Maze::Element(address.substr(0, separator)), Maze::Element("vortex_benchmark") });
+    if (separator != std::string::npos) {
+        mongo_config.set("port", Maze::Element(std::stoi(address.substr(separator + 1))));
+    }
+    mongo_config.set("pool", Maze::Element({ "max_size" }, { Maze::Element(16) }));
+
+    Mongo::Mongo mongo(mongo_config);
+    mongo.connect();
+
+    mongo.drop_database("vortex_benchmark");
+
+    Maze::Element documents(Maze::Type::Array);
+    for (int i = 0; i < document_count; ++i) {
+        documents.push_back(Maze::Element({ "index", "name", "method" }, {
+            Maze::Element(i), Maze::Element("controller_" + std::to_string(i)), Maze::Element(i % 2 == 0 ? "GET" : "POST") }));
+    }
+    mongo.get_collection("vortex_benchmark", "controllers").insert_many(documents);
+
+    // Every thread runs its queries with a client of its own from the pool, so throughput should scale until
+    // the pool (max_size) or mongod is saturated
+    for (int thread_count : { 1, 4, 16, 32 }) {
+        const double micros = Benchmarks::measure("find_one " + std::to_string(thread_count) + " threads", 5, [&mongo, thread_count]() {
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&mongo, t]() {
+                    Mongo::Collection collection = mongo.get_collection("vortex_benchmark", "controllers");
+
+                    for (int i = 0; i < queries_per_thread; ++i) {
+                        collection.find_one(Maze::Element({ "index" }, { Maze::Element((t * queries_per_thread + i) % document_count) }));
+                    }
+                    });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            });
+
+        printf("%-40s %12.0f queries/s\n", "", thread_count * queries_per_thread / (micros / 1000000.0));
+    }
+
+    mongo.drop_database("vortex_benchmark");
+
+    return 0;
+}
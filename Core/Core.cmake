@@ -3,9 +3,13 @@
 #
 set(CORE_SOURCES
     Core/Caching/Backends/RedisBackend.cpp
+    Core/Caching/Backends/MemcachedBackend.cpp
     Core/Caching/Backends/MemoryCacheBackend.cpp
+    Core/Caching/Backends/SharedMemoryCacheBackend.cpp
     Core/Caching/Backends/DummyCacheBackend.cpp
     Core/Caching/Cache.cpp
+    Core/Caching/CacheStatistics.cpp
+    Core/Caching/CacheWarmup.cpp
 
     Core/Exceptions/CacheException.cpp
     Core/Exceptions/ScriptException.cpp
@@ -16,14 +20,29 @@ set(CORE_SOURCES
     Core/Modules/ModuleLoader.cpp
     Core/Modules/Plugin.cpp
 
+    Core/Storage/CachingStorageBackend.cpp
+    Core/Storage/ChangeFeed.cpp
+    Core/Storage/Cursor.cpp
+    Core/Storage/QueryOptions.cpp
+    Core/Storage/RoutingStorageBackend.cpp
     Core/Storage/Storage.cpp
+    Core/Storage/Mongo/Bson.cpp
     Core/Storage/Mongo/Mongo.cpp
     Core/Storage/Mongo/Db.cpp
     Core/Storage/Mongo/Collection.cpp
     Core/Storage/Mongo/MongoBackend.cpp
+    Core/Storage/Mongo/MongoMetadata.cpp
     Core/Storage/Filesystem/FilesystemBackend.cpp
+    Core/Storage/Filesystem/FilesystemCollection.cpp
+    Core/Storage/Filesystem/FilesystemJsonLines.cpp
+    Core/Storage/Filesystem/FilesystemMappedCollection.cpp
+    Core/Storage/Filesystem/FilesystemSync.cpp
+    Core/Storage/Filesystem/FilesystemWatcher.cpp
+    Core/Storage/Filesystem/FilesystemWriteLog.cpp
 
+    Core/Util/Compression.cpp
     Core/Util/Hash.cpp
+    Core/Util/MessagePack.cpp
     Core/Util/Password.cpp
     Core/Util/Random.cpp
     Core/Util/String.cpp
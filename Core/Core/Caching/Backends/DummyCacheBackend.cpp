@@ -16,6 +16,10 @@ namespace Vortex::Core::Caching::Backends {
 
     void DummyCacheBackend::set_expiry(const std::string& key, int seconds) {}
 
+    void DummyCacheBackend::set_tags(const std::string& key, const std::vector<std::string>& tags) {}
+
+    void DummyCacheBackend::invalidate_tag(const std::string& tag) {}
+
     CacheBackendInterface* get_dummy_cache_backend() {
         static DummyCacheBackend instance;
         return &instance;
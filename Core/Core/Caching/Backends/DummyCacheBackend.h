@@ -12,6 +12,9 @@ namespace Vortex::Core::Caching::Backends {
         virtual bool exists(const std::string& key) override;
         virtual void remove(const std::string& key) override;
         virtual void set_expiry(const std::string& key, int seconds) override;
+
+        virtual void set_tags(const std::string& key, const std::vector<std::string>& tags) override;
+        virtual void invalidate_tag(const std::string& tag) override;
     };
 
 
@@ -0,0 +1,693 @@
+#include <Core/Caching/Backends/MemcachedBackend.h>
+#include <algorithm>
+#include <cstring>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <Core/Logging.h>
+#include <Core/Util/String.h>
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+
+namespace Vortex::Core::Caching::Backends {
+
+    namespace {
+
+        const uint8_t request_magic = 0x80;
+        const uint8_t response_magic = 0x81;
+        const size_t header_length = 24;
+        const size_t max_key_length = 250;
+
+        enum Opcode : uint8_t {
+            Get = 0x00,
+            Set = 0x01,
+            Delete = 0x04,
+            Increment = 0x05,
+            Noop = 0x0a,
+            GetKQ = 0x0d,
+            Touch = 0x1c
+        };
+
+        enum Status : uint16_t {
+            NoError = 0x00,
+            KeyNotFound = 0x01
+        };
+
+        // Stored values start with the magic, followed by the full key (empty unless the key was hashed),
+        // the tags with the versions they had when the value was stored and the value itself
+        const char stored_value_magic[4] = { 'V', 'X', 'M', '1' };
+
+
+        struct StoredValue {
+            std::string full_key;
+            std::vector<std::pair<std::string, uint64_t>> tag_versions;
+            std::string value;
+        };
+
+        void put_big_endian(std::string& output, uint64_t value, int bytes) {
+            for (int i = bytes - 1; i >= 0; --i) {
+                output.push_back((char)((value >> (i * 8)) & 0xff));
+            }
+        }
+
+        uint64_t get_big_endian(const unsigned char* data, int bytes) {
+            uint64_t value = 0;
+
+            for (int i = 0; i < bytes; ++i) {
+                value = (value << 8) | data[i];
+            }
+
+            return value;
+        }
+
+        uint32_t hash_value(const std::string& value) {
+            // FNV-1a, keys have to map to the same server in every process
+            uint32_t hash = 2166136261u;
+
+            for (unsigned char c : value) {
+                hash ^= c;
+                hash *= 16777619u;
+            }
+
+            return hash;
+        }
+
+        std::string expiration_extras(int seconds) {
+            std::string extras;
+            put_big_endian(extras, seconds > 0 ? seconds : 0, 4);
+
+            return extras;
+        }
+
+        // Counters that don't exist yet are created with the initial value and never expire
+        std::string increment_extras(uint64_t delta, uint64_t initial) {
+            std::string extras;
+            put_big_endian(extras, delta, 8);
+            put_big_endian(extras, initial, 8);
+            put_big_endian(extras, 0, 4);
+
+            return extras;
+        }
+
+        uint64_t current_time_micros() {
+            return std::chrono::duration_cast<std::chrono::microseconds>
+                (std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        std::string encode_stored_value(const std::string& full_key, const std::map<std::string, uint64_t>& tag_versions, const std::string& value) {
+            std::string stored_value(stored_value_magic, sizeof(stored_value_magic));
+
+            put_big_endian(stored_value, full_key.length(), 4);
+            stored_value.append(full_key);
+            put_big_endian(stored_value, tag_versions.size(), 1);
+
+            for (const auto& tag_version : tag_versions) {
+                put_big_endian(stored_value, tag_version.first.length(), 2);
+                stored_value.append(tag_version.first);
+                put_big_endian(stored_value, tag_version.second, 8);
+            }
+
+            return stored_value.append(value);
+        }
+
+        bool decode_stored_value(const std::string& stored_value, StoredValue& result) {
+            const unsigned char* data = (const unsigned char*)stored_value.data();
+            const size_t length = stored_value.length();
+            size_t position = sizeof(stored_value_magic);
+
+            if (length < position + 5 || std::memcmp(data, stored_value_magic, sizeof(stored_value_magic)) != 0) {
+                return false;
+            }
+
+            const size_t key_length = get_big_endian(data + position, 4);
+            position += 4;
+            if (length - position < key_length + 1) {
+                return false;
+            }
+            result.full_key = stored_value.substr(position, key_length);
+            position += key_length;
+
+            const size_t tag_count = data[position++];
+            for (size_t i = 0; i < tag_count; ++i) {
+                if (length - position < 2) {
+                    return false;
+                }
+                const size_t tag_length = get_big_endian(data + position, 2);
+                position += 2;
+
+                if (length - position < tag_length + 8) {
+                    return false;
+                }
+                std::string tag = stored_value.substr(position, tag_length);
+                position += tag_length;
+
+                result.tag_versions.push_back(std::make_pair(std::move(tag), get_big_endian(data + position, 8)));
+                position += 8;
+            }
+
+            result.value = stored_value.substr(position);
+
+            return true;
+        }
+
+    }  // namespace
+
+    MemcachedConnection::MemcachedConnection(int timeout_millis)
+        : _socket(_io_context), _timeout_millis(timeout_millis) {}
+
+    void MemcachedConnection::connect(const tcp::endpoint& endpoint) {
+        boost::system::error_code ec = asio::error::would_block;
+
+        _socket.async_connect(endpoint, [&ec](const boost::system::error_code& result) {
+            ec = result;
+            });
+
+        if (!wait(ec)) {
+            return;
+        }
+
+        _socket.set_option(tcp::no_delay(true), ec);
+
+        _healthy = true;
+    }
+
+    bool MemcachedConnection::is_healthy() const {
+        return _healthy;
+    }
+
+    bool MemcachedConnection::wait(const boost::system::error_code& ec) {
+        _io_context.restart();
+        _io_context.run_for(std::chrono::milliseconds(_timeout_millis));
+
+        // Operation is still pending after the deadline, closing the socket cancels it
+        if (!_io_context.stopped()) {
+            boost::system::error_code ignored;
+            _socket.close(ignored);
+
+            _io_context.restart();
+            _io_context.run();
+            _healthy = false;
+
+            return false;
+        }
+
+        if (ec) {
+            _healthy = false;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void MemcachedConnection::send(uint8_t opcode, const std::string& key, const std::string& extras, const std::string& value, uint32_t opaque) {
+        std::string packet;
+        packet.reserve(header_length + extras.length() + key.length() + value.length());
+
+        packet.push_back((char)request_magic);
+        packet.push_back((char)opcode);
+        put_big_endian(packet, key.length(), 2);
+        put_big_endian(packet, extras.length(), 1);
+        put_big_endian(packet, 0, 1);  // data type
+        put_big_endian(packet, 0, 2);  // vbucket
+        put_big_endian(packet, extras.length() + key.length() + value.length(), 4);
+        put_big_endian(packet, opaque, 4);
+        put_big_endian(packet, 0, 8);  // cas
+        packet.append(extras).append(key).append(value);
+
+        boost::system::error_code ec = asio::error::would_block;
+        asio::async_write(_socket, asio::buffer(packet), [&ec](const boost::system::error_code& result, size_t) {
+            ec = result;
+            });
+
+        wait(ec);
+    }
+
+    MemcachedResponse MemcachedConnection::receive() {
+        MemcachedResponse response;
+        unsigned char header[header_length];
+
+        boost::system::error_code ec = asio::error::would_block;
+        asio::async_read(_socket, asio::buffer(header, header_length), [&ec](const boost::system::error_code& result, size_t) {
+            ec = result;
+            });
+
+        if (!wait(ec) || header[0] != response_magic) {
+            _healthy = false;
+
+            return response;
+        }
+
+        const size_t key_length = get_big_endian(header + 2, 2);
+        const size_t extras_length = header[4];
+        const size_t body_length = get_big_endian(header + 8, 4);
+
+        response.opcode = header[1];
+        response.status = (uint16_t)get_big_endian(header + 6, 2);
+        response.opaque = (uint32_t)get_big_endian(header + 12, 4);
+
+        std::string body(body_length, '\0');
+        if (body_length > 0) {
+            ec = asio::error::would_block;
+            asio::async_read(_socket, asio::buffer(&body[0], body_length), [&ec](const boost::system::error_code& result, size_t) {
+                ec = result;
+                });
+
+            if (!wait(ec) || extras_length + key_length > body_length) {
+                _healthy = false;
+
+                return response;
+            }
+        }
+
+        response.key = body.substr(extras_length, key_length);
+        response.value = body.substr(extras_length + key_length);
+
+        return response;
+    }
+
+    MemcachedResponse MemcachedConnection::request(uint8_t opcode, const std::string& key, const std::string& extras, const std::string& value) {
+        send(opcode, key, extras, value);
+
+        if (!_healthy) {
+            return MemcachedResponse();
+        }
+
+        return receive();
+    }
+
+    MemcachedServer::MemcachedServer(const std::string& address, int port, size_t pool_size, int timeout_millis, int retry_millis)
+        : _name(address + ":" + std::to_string(port)),
+        _endpoint(asio::ip::make_address(address), (unsigned short)port),
+        _pool_size(pool_size),
+        _timeout_millis(timeout_millis),
+        _retry_millis(retry_millis) {}
+
+    std::unique_ptr<MemcachedConnection> MemcachedServer::acquire() {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            if (std::chrono::steady_clock::now() < _retry_at) {
+                return nullptr;
+            }
+
+            if (!_idle_connections.empty()) {
+                std::unique_ptr<MemcachedConnection> connection = std::move(_idle_connections.back());
+                _idle_connections.pop_back();
+
+                return connection;
+            }
+        }
+
+        // Pool is empty, connecting happens outside the lock
+        auto connection = std::make_unique<MemcachedConnection>(_timeout_millis);
+        connection->connect(_endpoint);
+
+        if (!connection->is_healthy()) {
+            mark_down();
+
+            return nullptr;
+        }
+
+        return connection;
+    }
+
+    void MemcachedServer::release(std::unique_ptr<MemcachedConnection> connection) {
+        if (!connection->is_healthy()) {
+            mark_down();
+
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        _failures = 0;
+
+        if (_idle_connections.size() < _pool_size) {
+            _idle_connections.push_back(std::move(connection));
+        }
+    }
+
+    const std::string& MemcachedServer::name() const {
+        return _name;
+    }
+
+    void MemcachedServer::mark_down() {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        // Other pooled connections most likely failed as well
+        _idle_connections.clear();
+
+        const int backoff_millis = std::min(_retry_millis << std::min(_failures, 5), 30000);
+        _retry_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoff_millis);
+        ++_failures;
+
+        VORTEX_WARN("Memcached server {0} is unavailable, retrying in {1} ms", _name, backoff_millis);
+    }
+
+    MemcachedBackend::MemcachedBackend() {}
+
+    MemcachedBackend::MemcachedBackend(const Maze::Element& memcached_config) {
+        set_config(memcached_config);
+    }
+
+    MemcachedBackend::~MemcachedBackend() {}
+
+    void MemcachedBackend::connect() {
+        if (!_enabled || !_servers.empty()) {
+            return;
+        }
+
+        std::vector<std::string> addresses;
+        if (_memcached_config.is_array("servers")) {
+            for (const auto& server : _memcached_config["servers"]) {
+                if (server.is_string()) {
+                    addresses.push_back(server.get_string());
+                }
+            }
+        }
+
+        if (addresses.empty()) {
+            addresses.push_back("127.0.0.1:11211");
+        }
+
+        for (const auto& address : addresses) {
+            std::vector<std::string> parts = Util::String::split(address, ":");
+
+            try {
+                _servers.push_back(std::make_unique<MemcachedServer>(
+                    parts[0], parts.size() > 1 ? std::stoi(parts[1]) : 11211, _pool_size, _timeout_millis, _retry_millis));
+            }
+            catch (const std::exception& e) {
+                VORTEX_ERROR("Invalid memcached server address {0}: {1}", address, e.what());
+
+                continue;
+            }
+
+            for (int i = 0; i < _virtual_nodes; ++i) {
+                _ring[hash_value(_servers.back()->name() + "-" + std::to_string(i))] = _servers.back().get();
+            }
+        }
+
+        if (_servers.empty()) {
+            _enabled = false;
+        }
+    }
+
+    void MemcachedBackend::set_config(const Maze::Element& memcached_config) {
+        _memcached_config = memcached_config;
+
+        if (_memcached_config.is_bool("enabled")) {
+            _enabled = _memcached_config["enabled"].get_bool();
+        }
+
+        if (_memcached_config.is_int("pool_size") && _memcached_config["pool_size"].get_int() > 0) {
+            _pool_size = _memcached_config["pool_size"].get_int();
+        }
+
+        if (_memcached_config.is_int("timeout_ms") && _memcached_config["timeout_ms"].get_int() > 0) {
+            _timeout_millis = _memcached_config["timeout_ms"].get_int();
+        }
+
+        if (_memcached_config.is_int("retry_ms") && _memcached_config["retry_ms"].get_int() > 0) {
+            _retry_millis = _memcached_config["retry_ms"].get_int();
+        }
+
+        if (_memcached_config.is_int("virtual_nodes") && _memcached_config["virtual_nodes"].get_int() > 0) {
+            _virtual_nodes = _memcached_config["virtual_nodes"].get_int();
+        }
+    }
+
+    const bool MemcachedBackend::is_enabled() const {
+        return _enabled;
+    }
+
+    const std::string MemcachedBackend::get(const std::string& key) {
+        MemcachedResponse response;
+
+        if (!execute(key, Get, "", "", response) || response.status != NoError) {
+            return "";
+        }
+
+        std::map<std::string, std::string> values;
+        values[key] = response.value;
+        unwrap_values(values);
+
+        return values.empty() ? "" : values.begin()->second;
+    }
+
+    void MemcachedBackend::set(const std::string& key, const std::string& value, int expire_seconds) {
+        store(key, value, expire_seconds, {});
+    }
+
+    bool MemcachedBackend::exists(const std::string& key) {
+        // Binary protocol has no exists command, touch would change the expiry. The tags of the value have to be checked as well.
+        return !get(key).empty();
+    }
+
+    void MemcachedBackend::remove(const std::string& key) {
+        MemcachedResponse response;
+
+        execute(key, Delete, "", "", response);
+    }
+
+    void MemcachedBackend::set_expiry(const std::string& key, int seconds) {
+        MemcachedResponse response;
+
+        execute(key, Touch, expiration_extras(seconds), "", response);
+    }
+
+    void MemcachedBackend::set_tags(const std::string& key, const std::vector<std::string>& tags) {
+        // Tag versions are stored with the value, which can't be rewritten without knowing its remaining expiry.
+        // Value is removed instead so it can't outlive an invalidation of the tags, set_tagged() stores both at once.
+        if (!tags.empty()) {
+            remove(key);
+        }
+    }
+
+    void MemcachedBackend::set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+        // Versions are read before the value is written, an invalidation in between makes the value stale right away
+        const std::map<std::string, uint64_t> tag_versions = get_tag_versions(tags, true);
+
+        for (const auto& tag : tags) {
+            if (tag_versions.find(tag) == tag_versions.end()) {
+                // Value could not be checked against the unreachable tag
+                remove(key);
+
+                return;
+            }
+        }
+
+        store(key, value, expire_seconds, tag_versions);
+    }
+
+    void MemcachedBackend::invalidate_tag(const std::string& tag) {
+        MemcachedResponse response;
+
+        // Missing counters are created with the current time, so they never return to a version stored earlier
+        if (!execute(tag_version_key(tag), Increment, increment_extras(1, current_time_micros()), "", response) ||
+            response.status != NoError) {
+            VORTEX_WARN("Unable to invalidate memcached tag {0}", tag);
+        }
+    }
+
+    std::map<std::string, std::string> MemcachedBackend::get_multi(const std::vector<std::string>& keys) {
+        std::map<std::string, std::string> values = get_stored_values(keys);
+
+        unwrap_values(values);
+
+        return values;
+    }
+
+    std::map<std::string, std::string> MemcachedBackend::get_stored_values(const std::vector<std::string>& keys) {
+        std::map<std::string, std::string> values;
+        std::map<MemcachedServer*, std::vector<std::string>> server_keys;
+
+        if (!_enabled || _ring.empty()) {
+            return values;
+        }
+
+        for (const auto& key : keys) {
+            server_keys[server_for(memcached_key(key))].push_back(key);
+        }
+
+        // Quiet gets only answer hits, the final noop marks the end of the batch
+        for (auto& batch : server_keys) {
+            std::unique_ptr<MemcachedConnection> connection = batch.first->acquire();
+            if (!connection) {
+                continue;
+            }
+
+            for (uint32_t i = 0; i < batch.second.size() && connection->is_healthy(); ++i) {
+                connection->send(GetKQ, memcached_key(batch.second[i]), "", "", i);
+            }
+            connection->send(Noop, "");
+
+            while (connection->is_healthy()) {
+                MemcachedResponse response = connection->receive();
+
+                if (!connection->is_healthy() || response.opcode == Noop) {
+                    break;
+                }
+
+                if (response.status == NoError && response.opaque < batch.second.size()) {
+                    values[batch.second[response.opaque]] = response.value;
+                }
+            }
+
+            batch.first->release(std::move(connection));
+        }
+
+        return values;
+    }
+
+    void MemcachedBackend::unwrap_values(std::map<std::string, std::string>& values) {
+        std::map<std::string, StoredValue> stored_values;
+        std::vector<std::string> tags;
+
+        for (auto it = values.begin(); it != values.end();) {
+            StoredValue stored_value;
+
+            // Keys longer than memcached allows share a hashed key, the full key tells them apart
+            if (!decode_stored_value(it->second, stored_value) ||
+                (!stored_value.full_key.empty() && stored_value.full_key != it->first)) {
+                it = values.erase(it);
+
+                continue;
+            }
+
+            for (const auto& tag_version : stored_value.tag_versions) {
+                tags.push_back(tag_version.first);
+            }
+
+            stored_values[it->first] = std::move(stored_value);
+            ++it;
+        }
+
+        const std::map<std::string, uint64_t> tag_versions = tags.empty() ?
+            std::map<std::string, uint64_t>() : get_tag_versions(tags, false);
+
+        for (auto& stored_value : stored_values) {
+            bool is_current = true;
+
+            for (const auto& tag_version : stored_value.second.tag_versions) {
+                const auto& it = tag_versions.find(tag_version.first);
+
+                is_current = is_current && it != tag_versions.end() && it->second == tag_version.second;
+            }
+
+            if (is_current) {
+                values[stored_value.first] = std::move(stored_value.second.value);
+            }
+            else {
+                values.erase(stored_value.first);
+            }
+        }
+    }
+
+    std::map<std::string, uint64_t> MemcachedBackend::get_tag_versions(const std::vector<std::string>& tags, bool create) {
+        std::map<std::string, uint64_t> versions;
+        std::vector<std::string> version_keys;
+
+        for (const auto& tag : tags) {
+            version_keys.push_back(tag_version_key(tag));
+        }
+
+        const std::map<std::string, std::string> stored_versions = get_stored_values(version_keys);
+
+        for (const auto& tag : tags) {
+            const auto& it = stored_versions.find(tag_version_key(tag));
+
+            if (it != stored_versions.end()) {
+                try {
+                    versions[tag] = std::stoull(it->second);
+                }
+                catch (const std::exception&) {}
+            }
+            else if (create && versions.find(tag) == versions.end()) {
+                // Increment by zero creates the counter or returns the one another process created in the meantime
+                MemcachedResponse response;
+
+                if (execute(tag_version_key(tag), Increment, increment_extras(0, current_time_micros()), "", response) &&
+                    response.status == NoError && response.value.length() == 8) {
+                    versions[tag] = get_big_endian((const unsigned char*)response.value.data(), 8);
+                }
+            }
+        }
+
+        return versions;
+    }
+
+    void MemcachedBackend::store(const std::string& key, const std::string& value, int expire_seconds, const std::map<std::string, uint64_t>& tag_versions) {
+        MemcachedResponse response;
+
+        // Tag count is stored in a single byte
+        if (tag_versions.size() > UINT8_MAX) {
+            remove(key);
+
+            return;
+        }
+
+        std::string extras;
+        put_big_endian(extras, 0, 4);  // flags
+        extras.append(expiration_extras(expire_seconds));
+
+        const std::string full_key = memcached_key(key) != key ? key : "";
+
+        execute(key, Set, extras, encode_stored_value(full_key, tag_versions, value), response);
+    }
+
+    MemcachedServer* MemcachedBackend::server_for(const std::string& key) const {
+        auto it = _ring.lower_bound(hash_value(key));
+
+        if (it == _ring.end()) {
+            it = _ring.begin();
+        }
+
+        return it->second;
+    }
+
+    bool MemcachedBackend::execute(const std::string& key, uint8_t opcode, const std::string& extras, const std::string& value, MemcachedResponse& response) {
+        if (!_enabled || _ring.empty()) {
+            return false;
+        }
+
+        const std::string server_key = memcached_key(key);
+        MemcachedServer* server = server_for(server_key);
+
+        // Server is down and waiting for its next retry
+        std::unique_ptr<MemcachedConnection> connection = server->acquire();
+        if (!connection) {
+            return false;
+        }
+
+        response = connection->request(opcode, server_key, extras, value);
+        bool success = connection->is_healthy();
+
+        server->release(std::move(connection));
+
+        return success;
+    }
+
+    const std::string MemcachedBackend::memcached_key(const std::string& key) {
+        if (key.length() <= max_key_length) {
+            return key;
+        }
+
+        // Memcached keys are limited to 250 bytes. Colliding keys can overwrite each other,
+        // but the full key is stored with the value and compared on read.
+        return "vortex.hashed." + std::to_string(hash_value(key)) + "." + std::to_string(key.length()) + "." +
+            key.substr(key.length() - 64);
+    }
+
+    const std::string MemcachedBackend::tag_version_key(const std::string& tag) {
+        return memcached_key("vortex.tag_version." + tag);
+    }
+
+    CacheBackendInterface* get_memcached_backend() {
+        static MemcachedBackend instance;
+        return &instance;
+    }
+
+}
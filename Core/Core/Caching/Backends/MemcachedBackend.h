@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <Core/Caching/Cache.h>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Caching::Backends {
+
+    struct MemcachedResponse {
+        uint8_t opcode = 0;
+        uint16_t status = 0;
+        uint32_t opaque = 0;
+        std::string key;
+        std::string value;
+    };
+
+
+    // Single connection speaking the memcached binary protocol.
+    // Every operation runs asynchronously on the connection's own io_context with a deadline of timeout_millis,
+    // an operation that doesn't finish in time closes the socket and leaves the connection unhealthy.
+    class MemcachedConnection {
+    public:
+        MemcachedConnection(int timeout_millis);
+
+        void connect(const boost::asio::ip::tcp::endpoint& endpoint);
+        bool is_healthy() const;
+
+        void send(uint8_t opcode, const std::string& key, const std::string& extras = "", const std::string& value = "", uint32_t opaque = 0);
+        MemcachedResponse receive();
+        MemcachedResponse request(uint8_t opcode, const std::string& key, const std::string& extras = "", const std::string& value = "");
+
+    private:
+        boost::asio::io_context _io_context;
+        boost::asio::ip::tcp::socket _socket;
+        int _timeout_millis;
+        bool _healthy = false;
+
+        // Runs the started operation until it completes or the deadline passes
+        bool wait(const boost::system::error_code& ec);
+    };
+
+
+    // Idle connections of one memcached server.
+    // Server is skipped for retry_millis after a failure, the period doubles with every further failure up to 30s.
+    class MemcachedServer {
+    public:
+        MemcachedServer(const std::string& address, int port, size_t pool_size, int timeout_millis, int retry_millis);
+
+        // Returns nullptr while the server is marked down or when it can't be connected to
+        std::unique_ptr<MemcachedConnection> acquire();
+        void release(std::unique_ptr<MemcachedConnection> connection);
+
+        const std::string& name() const;
+
+    private:
+        std::string _name;
+        boost::asio::ip::tcp::endpoint _endpoint;
+        size_t _pool_size;
+        int _timeout_millis;
+        int _retry_millis;
+        int _failures = 0;
+        std::chrono::steady_clock::time_point _retry_at;
+        std::vector<std::unique_ptr<MemcachedConnection>> _idle_connections;
+        std::mutex _mtx;
+
+        void mark_down();
+    };
+
+
+    class MemcachedBackend : public CacheBackendInterface {
+    public:
+        MemcachedBackend();
+        MemcachedBackend(const Maze::Element& memcached_config);
+        ~MemcachedBackend();
+
+        void connect();
+        void set_config(const Maze::Element& memcached_config);
+        const bool is_enabled() const;
+
+        virtual const std::string get(const std::string& key) override;
+        virtual void set(const std::string& key, const std::string& value, int expire_seconds = 180) override;
+        virtual bool exists(const std::string& key) override;
+        virtual void remove(const std::string& key) override;
+        virtual void set_expiry(const std::string& key, int seconds) override;
+
+        // Tags are versioned: every tag has a counter that invalidate_tag increments. Values are stored with the
+        // versions of their tags and are treated as missing once one of them changed or can't be read.
+        virtual void set_tags(const std::string& key, const std::vector<std::string>& tags) override;
+        virtual void invalidate_tag(const std::string& tag) override;
+        virtual void set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) override;
+
+        virtual std::map<std::string, std::string> get_multi(const std::vector<std::string>& keys) override;
+
+    private:
+        Maze::Element _memcached_config;
+        bool _enabled = false;
+        size_t _pool_size = 4;
+        int _timeout_millis = 1000;
+        int _retry_millis = 1000;
+        int _virtual_nodes = 160;
+        std::vector<std::unique_ptr<MemcachedServer>> _servers;
+        // Consistent hash ring, points of every server are spread by virtual nodes
+        std::map<uint32_t, MemcachedServer*> _ring;
+
+        MemcachedServer* server_for(const std::string& key) const;
+        // Runs a single request against the server owning the key, returns false on connection errors
+        bool execute(const std::string& key, uint8_t opcode, const std::string& extras, const std::string& value, MemcachedResponse& response);
+        // Stored values without unwrapping, one pipelined batch per server
+        std::map<std::string, std::string> get_stored_values(const std::vector<std::string>& keys);
+        // Unwraps the stored values and drops the ones with outdated tags or a different full key
+        void unwrap_values(std::map<std::string, std::string>& values);
+        // Current versions of the tags, created when missing unless create is false. Unreachable tags are left out.
+        std::map<std::string, uint64_t> get_tag_versions(const std::vector<std::string>& tags, bool create);
+        void store(const std::string& key, const std::string& value, int expire_seconds, const std::map<std::string, uint64_t>& tag_versions);
+
+        static const std::string memcached_key(const std::string& key);
+        static const std::string tag_version_key(const std::string& tag);
+    };
+
+
+    CacheBackendInterface* get_memcached_backend();
+
+
+    static const CacheBackendDetails memcached_exports = {
+        "MemcachedBackend",
+        "Memcached",
+        get_memcached_backend
+    };
+
+}  // namespace Vortex::Core::Caching::Backends
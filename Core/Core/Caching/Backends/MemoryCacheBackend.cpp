@@ -1,15 +1,121 @@
 #include <Core/Caching/Backends/MemoryCacheBackend.h>
 #include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <Core/GlobalRuntime.h>
+#include <Core/Logging.h>
 
 namespace Vortex::Core::Caching::Backends {
 
+    namespace {
+
+        const char snapshot_magic[8] = { 'V', 'X', 'M', 'C', 'S', 'N', 'P', '1' };
+
+        CacheCounterGroup& backend_statistics() {
+            static CacheCounterGroup& counters = GlobalRuntime::instance().cache().statistics().backend_group(memory_cache_exports.backend_name);
+
+            return counters;
+        }
+
+        void write_value(std::ofstream& stream, uint64_t value) {
+            stream.write((const char*)&value, sizeof(value));
+        }
+
+        void write_string(std::ofstream& stream, const std::string& value) {
+            write_value(stream, value.length());
+            stream.write(value.data(), value.length());
+        }
+
+
+        // The snapshot has to be on disk before the rename replaces the previous one
+        bool sync_file(const std::string& path) {
+#ifdef _WIN32
+            int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+            if (fd < 0) {
+                return false;
+            }
+
+            bool synced = (_commit(fd) == 0);
+            _close(fd);
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+
+            bool synced = (::fsync(fd) == 0);
+            ::close(fd);
+#endif
+
+            return synced;
+        }
+
+
+        class SnapshotReader {
+        public:
+            SnapshotReader(const char* data, size_t length)
+                : _data(data), _length(length) {}
+
+            bool read_value(uint64_t& value) {
+                if (_length - _position < sizeof(value)) {
+                    return false;
+                }
+
+                std::memcpy(&value, _data + _position, sizeof(value));
+                _position += sizeof(value);
+
+                return true;
+            }
+
+            bool read_string(std::string& value) {
+                uint64_t length;
+                if (!read_value(length) || _length - _position < length) {
+                    return false;
+                }
+
+                value.assign(_data + _position, length);
+                _position += length;
+
+                return true;
+            }
+
+            bool skip(size_t length) {
+                if (_length - _position < length) {
+                    return false;
+                }
+
+                _position += length;
+
+                return true;
+            }
+
+        private:
+            const char* _data;
+            size_t _length;
+            size_t _position = 0;
+        };
+
+    }  // namespace
+
     MemoryCacheBackend::MemoryCacheBackend() {}
 
     MemoryCacheBackend::MemoryCacheBackend(const Maze::Element& cache_config) {
         set_config(cache_config);
     }
 
-    MemoryCacheBackend::~MemoryCacheBackend() {}
+    MemoryCacheBackend::~MemoryCacheBackend() {
+        stop_snapshots();
+    }
 
     void MemoryCacheBackend::set_config(const Maze::Element& cache_config) {
         _cache_config = cache_config;
@@ -17,6 +123,27 @@ namespace Vortex::Core::Caching::Backends {
         if (_cache_config.is_bool("enabled")) {
             _enabled = _cache_config["enabled"].get_bool();
         }
+
+        if (_cache_config.is_int("max_entries") && _cache_config["max_entries"].get_int() >= 0) {
+            _max_entries = _cache_config["max_entries"].get_int();
+        }
+
+        if (_cache_config.is_string("snapshot_path")) {
+            _snapshot_path = _cache_config["snapshot_path"].get_string();
+        }
+
+        if (_cache_config.is_int("snapshot_interval") && _cache_config["snapshot_interval"].get_int() > 0) {
+            _snapshot_interval = _cache_config["snapshot_interval"].get_int();
+        }
+
+        if (_enabled && !_snapshot_path.empty()) {
+            if (!_snapshot_loaded) {
+                load_snapshot();
+                _snapshot_loaded = true;
+            }
+
+            start_snapshots();
+        }
     }
 
     const bool MemoryCacheBackend::is_enabled() const {
@@ -25,17 +152,31 @@ namespace Vortex::Core::Caching::Backends {
 
     const std::string MemoryCacheBackend::get(const std::string& key) {
         if (_enabled) {
-            auto it = _cache_map.find(key);
-            if (it != _cache_map.end()) {
-                long long expiry_timestamp = it->second->second.expiry_timestamp;
-                if (expiry_timestamp == 0 ||
-                    get_current_time_millis() - expiry_timestamp < 100) {
-                    return it->second->second.value;
-                }
-                else {
-                    remove(key);
+            std::shared_ptr<const std::string> value;
+
+            {
+                std::lock_guard<std::mutex> lock(_mtx);
+
+                auto it = _cache_map.find(key);
+                if (it != _cache_map.end()) {
+                    long long expiry_timestamp = it->second->second.expiry_timestamp;
+                    if (expiry_timestamp == 0 ||
+                        get_current_time_millis() - expiry_timestamp < 100) {
+                        // Most recently used entries are kept at the front of the list
+                        _cache_list.splice(_cache_list.begin(), _cache_list, it->second);
+
+                        value = it->second->second.value;
+                    }
+                    else {
+                        expire_entry(key);
+                    }
                 }
             }
+
+            // Value is copied out without holding the lock
+            if (value) {
+                return *value;
+            }
         }
 
         return "";
@@ -43,21 +184,16 @@ namespace Vortex::Core::Caching::Backends {
 
     void MemoryCacheBackend::set(const std::string& key, const std::string& value, int expire_seconds) {
         if (_enabled) {
-            remove(key);
+            std::lock_guard<std::mutex> lock(_mtx);
 
-            long long expires_at = expire_seconds > 0 ? get_current_time_millis() + (expire_seconds * (long long)60) * 1000 : 0;
-            MemoryCacheEntry entry{
-                expires_at,
-                value
-            };
-
-            _cache_list.push_front(std::make_pair(key, entry));
-            _cache_map[key] = _cache_list.begin();
+            insert_entry(key, value, expire_seconds, {});
         }
     }
 
     bool MemoryCacheBackend::exists(const std::string& key) {
         if (_enabled) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
             const auto& it = _cache_map.find(key);
             if (it != _cache_map.end()) {
                 if (it->second->second.expiry_timestamp == 0 ||
@@ -65,7 +201,7 @@ namespace Vortex::Core::Caching::Backends {
                     return true;
                 }
                 else {
-                    remove(key);
+                    expire_entry(key);
                 }
             }
         }
@@ -75,16 +211,16 @@ namespace Vortex::Core::Caching::Backends {
 
     void MemoryCacheBackend::remove(const std::string& key) {
         if (_enabled) {
-            const auto& it = _cache_map.find(key);
-            if (it != _cache_map.end()) {
-                _cache_list.erase(it->second);
-                _cache_map.erase(key);
-            }
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            remove_entry(key);
         }
     }
 
     void MemoryCacheBackend::set_expiry(const std::string& key, int seconds) {
         if (_enabled) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
             const auto& it = _cache_map.find(key);
             if (it != _cache_map.end()) {
                 if (it->second->second.expiry_timestamp == 0 ||
@@ -93,17 +229,291 @@ namespace Vortex::Core::Caching::Backends {
                         seconds != 0 ? get_current_time_millis() + (seconds * (long long)60) * 1000 : 0;
                 }
                 else {
-                    remove(key);
+                    expire_entry(key);
+                }
+            }
+        }
+    }
+
+    void MemoryCacheBackend::set_tags(const std::string& key, const std::vector<std::string>& tags) {
+        if (_enabled) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            const auto& it = _cache_map.find(key);
+            if (it != _cache_map.end()) {
+                std::vector<std::string> entry_tags = *it->second->second.tags;
+
+                for (const auto& tag : tags) {
+                    if (_tag_map[tag].insert(key).second) {
+                        entry_tags.push_back(tag);
+                    }
+                }
+
+                it->second->second.tags = std::make_shared<const std::vector<std::string>>(std::move(entry_tags));
+            }
+        }
+    }
+
+    void MemoryCacheBackend::set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+        if (_enabled) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            insert_entry(key, value, expire_seconds, tags);
+        }
+    }
+
+    void MemoryCacheBackend::invalidate_tag(const std::string& tag) {
+        if (_enabled) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            const auto& it = _tag_map.find(tag);
+            if (it != _tag_map.end()) {
+                // remove_entry() modifies the tag index, so the keys need to be copied first
+                const std::vector<std::string> keys(it->second.begin(), it->second.end());
+
+                for (const auto& key : keys) {
+                    remove_entry(key);
+                }
+
+                _tag_map.erase(tag);
+            }
+        }
+    }
+
+    void MemoryCacheBackend::insert_entry(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+        remove_entry(key);
+
+        long long expires_at = expire_seconds > 0 ? get_current_time_millis() + (expire_seconds * (long long)60) * 1000 : 0;
+        std::vector<std::string> entry_tags;
+
+        for (const auto& tag : tags) {
+            if (_tag_map[tag].insert(key).second) {
+                entry_tags.push_back(tag);
+            }
+        }
+
+        MemoryCacheEntry entry{
+            expires_at,
+            std::make_shared<const std::string>(value),
+            std::make_shared<const std::vector<std::string>>(std::move(entry_tags))
+        };
+
+        _cache_list.push_front(std::make_pair(std::make_shared<const std::string>(key), std::move(entry)));
+        _cache_map[key] = _cache_list.begin();
+
+        while (_max_entries > 0 && _cache_map.size() > _max_entries) {
+            const std::string evicted_key = *_cache_list.back().first;
+
+            remove_entry(evicted_key);
+            GlobalRuntime::instance().cache().statistics().record_eviction(backend_statistics(), evicted_key);
+        }
+    }
+
+    void MemoryCacheBackend::remove_entry(const std::string& key) {
+        const auto& it = _cache_map.find(key);
+        if (it != _cache_map.end()) {
+            for (const auto& tag : *it->second->second.tags) {
+                const auto& tag_it = _tag_map.find(tag);
+                if (tag_it != _tag_map.end()) {
+                    tag_it->second.erase(key);
+
+                    if (tag_it->second.empty()) {
+                        _tag_map.erase(tag_it);
+                    }
                 }
             }
+
+            _cache_list.erase(it->second);
+            _cache_map.erase(key);
         }
     }
 
+    void MemoryCacheBackend::expire_entry(const std::string& key) {
+        remove_entry(key);
+        GlobalRuntime::instance().cache().statistics().record_expiration(backend_statistics(), key);
+    }
+
     long long MemoryCacheBackend::get_current_time_millis() const {
         return std::chrono::duration_cast<std::chrono::milliseconds>
             (std::chrono::system_clock::now().time_since_epoch()).count();
     }
 
+    void MemoryCacheBackend::start_snapshots() {
+        if (_snapshot_running.exchange(true)) {
+            return;
+        }
+
+        _snapshot_thread = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(_snapshot_mtx);
+
+            while (_snapshot_running) {
+                _snapshot_cv.wait_for(lock, std::chrono::seconds(_snapshot_interval), [this]() { return !_snapshot_running; });
+
+                if (_snapshot_running && !write_snapshot()) {
+                    VORTEX_ERROR("Unable to write memory cache snapshot to {0}", _snapshot_path);
+                }
+            }
+            });
+    }
+
+    void MemoryCacheBackend::stop_snapshots() {
+        if (!_snapshot_running) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_snapshot_mtx);
+            _snapshot_running = false;
+        }
+        _snapshot_cv.notify_all();
+
+        if (_snapshot_thread.joinable()) {
+            _snapshot_thread.join();
+        }
+
+        // Final snapshot on shutdown, logger might already be gone so failures are ignored
+        write_snapshot();
+    }
+
+    bool MemoryCacheBackend::write_snapshot() {
+        std::vector<MemoryCacheEntryPair> entries;
+
+        {
+            // Only the shared pointers are copied under the lock, serialization and disk writes happen without it
+            std::lock_guard<std::mutex> lock(_mtx);
+            entries.assign(_cache_list.begin(), _cache_list.end());
+        }
+
+        const std::string temporary_path = _snapshot_path + ".tmp";
+        const long long current_time = get_current_time_millis();
+
+        std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        stream.write(snapshot_magic, sizeof(snapshot_magic));
+        write_value(stream, entries.size());
+
+        // Most recently used entries first, expiry is stored as the remaining ttl (0 never expires)
+        for (const auto& entry : entries) {
+            long long remaining_millis = 0;
+
+            if (entry.second.expiry_timestamp != 0) {
+                remaining_millis = entry.second.expiry_timestamp - current_time;
+
+                if (remaining_millis <= 0) {
+                    remaining_millis = 1;
+                }
+            }
+
+            write_value(stream, remaining_millis);
+            write_string(stream, *entry.first);
+            write_string(stream, *entry.second.value);
+            write_value(stream, entry.second.tags->size());
+
+            for (const auto& tag : *entry.second.tags) {
+                write_string(stream, tag);
+            }
+        }
+
+        stream.close();
+        if (stream.fail() || !sync_file(temporary_path)) {
+            return false;
+        }
+
+        boost::system::error_code ec;
+        boost::filesystem::rename(temporary_path, _snapshot_path, ec);
+
+        return !ec;
+    }
+
+    void MemoryCacheBackend::load_snapshot() {
+        boost::system::error_code ec;
+        if (!boost::filesystem::exists(_snapshot_path, ec) || boost::filesystem::file_size(_snapshot_path, ec) == 0) {
+            return;
+        }
+
+        try {
+            boost::interprocess::file_mapping snapshot_file(_snapshot_path.c_str(), boost::interprocess::read_only);
+            boost::interprocess::mapped_region region(snapshot_file, boost::interprocess::read_only);
+
+            SnapshotReader reader(static_cast<const char*>(region.get_address()), region.get_size());
+            const long long current_time = get_current_time_millis();
+
+            if (region.get_size() < sizeof(snapshot_magic) ||
+                std::memcmp(region.get_address(), snapshot_magic, sizeof(snapshot_magic)) != 0) {
+                VORTEX_WARN("Ignoring memory cache snapshot {0} with unknown format", _snapshot_path);
+
+                return;
+            }
+            reader.skip(sizeof(snapshot_magic));
+
+            uint64_t entry_count;
+            if (!reader.read_value(entry_count)) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(_mtx);
+            size_t loaded_entries = 0;
+
+            for (uint64_t i = 0; i < entry_count; ++i) {
+                uint64_t remaining_millis, tag_count;
+                std::string key, value;
+
+                if (!reader.read_value(remaining_millis) ||
+                    !reader.read_string(key) ||
+                    !reader.read_string(value) ||
+                    !reader.read_value(tag_count)) {
+                    VORTEX_WARN("Memory cache snapshot {0} is truncated", _snapshot_path);
+                    break;
+                }
+
+                std::vector<std::string> tags;
+                for (uint64_t t = 0; t < tag_count; ++t) {
+                    std::string tag;
+                    if (!reader.read_string(tag)) {
+                        break;
+                    }
+
+                    tags.push_back(tag);
+                }
+
+                // Entry missing some of its tags would survive their invalidation
+                if (tags.size() != tag_count) {
+                    VORTEX_WARN("Memory cache snapshot {0} is truncated", _snapshot_path);
+                    break;
+                }
+
+                if ((_max_entries > 0 && _cache_map.size() >= _max_entries) ||
+                    _cache_map.find(key) != _cache_map.end()) {
+                    continue;
+                }
+
+                for (const auto& tag : tags) {
+                    _tag_map[tag].insert(key);
+                }
+
+                MemoryCacheEntry entry{
+                    remaining_millis != 0 ? current_time + (long long)remaining_millis : 0,
+                    std::make_shared<const std::string>(std::move(value)),
+                    std::make_shared<const std::vector<std::string>>(std::move(tags))
+                };
+
+                // Entries are stored most recently used first, so they are appended to keep the order
+                _cache_list.push_back(std::make_pair(std::make_shared<const std::string>(key), std::move(entry)));
+                _cache_map[key] = std::prev(_cache_list.end());
+
+                ++loaded_entries;
+            }
+
+            VORTEX_INFO("Loaded {0} memory cache entries from snapshot {1}", loaded_entries, _snapshot_path);
+        }
+        catch (const std::exception& e) {
+            VORTEX_ERROR("Unable to load memory cache snapshot {0}: {1}", _snapshot_path, e.what());
+        }
+    }
+
     CacheBackendInterface* get_memory_cache_backend() {
         static MemoryCacheBackend instance;
         return &instance;
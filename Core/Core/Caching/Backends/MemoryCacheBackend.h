@@ -1,21 +1,30 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 #include <Core/Caching/Cache.h>
 #include <Maze/Maze.hpp>
 
 namespace Vortex::Core::Caching::Backends {
     
+    // Key, value and tags are immutable and shared, so snapshots and readers only copy pointers under the lock
     struct MemoryCacheEntry {
         long long expiry_timestamp;
-        std::string value;
+        std::shared_ptr<const std::string> value;
+        std::shared_ptr<const std::vector<std::string>> tags;
     };
 
 
-    typedef std::pair<std::string, MemoryCacheEntry> MemoryCacheEntryPair;
+    typedef std::pair<std::shared_ptr<const std::string>, MemoryCacheEntry> MemoryCacheEntryPair;
     typedef std::list<MemoryCacheEntryPair> MemoryCacheList;
     typedef boost::unordered_map<std::string, MemoryCacheList::iterator> MemoryCacheMap;
+    typedef boost::unordered_map<std::string, boost::unordered_set<std::string>> MemoryCacheTagMap;
 
 
     class MemoryCacheBackend : public CacheBackendInterface {
@@ -33,13 +42,39 @@ namespace Vortex::Core::Caching::Backends {
         virtual void remove(const std::string&  key) override;
         virtual void set_expiry(const std::string& key, int seconds) override;
 
+        virtual void set_tags(const std::string& key, const std::vector<std::string>& tags) override;
+        virtual void invalidate_tag(const std::string& tag) override;
+        virtual void set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) override;
+
     private:
         Maze::Element _cache_config;
         bool _enabled = false;
+        // Least recently used entries are evicted above max_entries, 0 keeps every entry
+        // (required when filesystem storage runs in_memory_only)
+        size_t _max_entries = 0;
+        std::string _snapshot_path;
+        int _snapshot_interval = 60;
+        bool _snapshot_loaded = false;
+        std::thread _snapshot_thread;
+        std::atomic<bool> _snapshot_running{ false };
+        std::condition_variable _snapshot_cv;
+        std::mutex _snapshot_mtx;
         MemoryCacheList _cache_list;
         MemoryCacheMap _cache_map;
+        MemoryCacheTagMap _tag_map;
+        std::mutex _mtx;
 
+        // Must be called with _mtx locked
+        void insert_entry(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags);
+        void remove_entry(const std::string& key);
+        void expire_entry(const std::string& key);
         long long get_current_time_millis() const;
+
+        // Snapshots keep the remaining ttl of entries so warm restarts do not extend their lifetime
+        void start_snapshots();
+        void stop_snapshots();
+        bool write_snapshot();
+        void load_snapshot();
     };
 
 
@@ -2,6 +2,54 @@
 
 namespace Vortex::Core::Caching::Backends {
 
+    namespace {
+
+        // Adds KEYS[1] to the tag sets in KEYS[2..], ttl is the one of the key in seconds (0 never expires).
+        // Tag sets live as long as their longest lived member instead of growing forever.
+        const std::string add_to_tags_lua = R"(
+            for i = 2, #KEYS do
+                local tag_ttl = redis.call('TTL', KEYS[i])
+                redis.call('SADD', KEYS[i], KEYS[1])
+                if ttl == 0 then
+                    redis.call('PERSIST', KEYS[i])
+                elseif tag_ttl == -2 or (tag_ttl >= 0 and tag_ttl < ttl) then
+                    redis.call('EXPIRE', KEYS[i], ttl)
+                end
+            end
+            return 1
+        )";
+
+        // ARGV[1] is the value, ARGV[2] its ttl in seconds
+        const std::string set_tagged_script = R"(
+            local ttl = tonumber(ARGV[2])
+            if ttl > 0 then
+                redis.call('SET', KEYS[1], ARGV[1], 'EX', ttl)
+            else
+                redis.call('SET', KEYS[1], ARGV[1])
+            end
+        )" + add_to_tags_lua;
+
+        const std::string set_tags_script = R"(
+            local ttl = redis.call('TTL', KEYS[1])
+            if ttl == -2 then
+                return 0
+            elseif ttl == -1 then
+                ttl = 0
+            end
+        )" + add_to_tags_lua;
+
+        // KEYS[1] is the tag set, its members and the set itself are removed in one step
+        const std::string invalidate_tag_script = R"(
+            local members = redis.call('SMEMBERS', KEYS[1])
+            for i = 1, #members, 1000 do
+                redis.call('DEL', unpack(members, i, math.min(i + 999, #members)))
+            end
+            redis.call('DEL', KEYS[1])
+            return #members
+        )";
+
+    }  // namespace
+
     RedisBackend::RedisBackend() {}
 
     RedisBackend::RedisBackend(const Maze::Element& redis_config) {
@@ -120,6 +168,57 @@ namespace Vortex::Core::Caching::Backends {
 #endif
     }
 
+    void RedisBackend::set_tags(const std::string& key, const std::vector<std::string>& tags) {
+#ifdef HAS_FEATURE_CPPREDIS
+        if (_enabled && _client.is_connected()) {
+            std::vector<std::string> keys;
+            keys.push_back(key);
+            for (const auto& tag : tags) {
+                keys.push_back(get_tag_key(tag));
+            }
+
+            std::future<cpp_redis::reply> reply = _client.eval(set_tags_script, (int)keys.size(), keys, {});
+            _client.sync_commit();
+            reply.wait();
+        }
+#endif
+    }
+
+    void RedisBackend::set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+#ifdef HAS_FEATURE_CPPREDIS
+        if (_enabled && _client.is_connected()) {
+            std::vector<std::string> keys;
+            keys.push_back(key);
+            for (const auto& tag : tags) {
+                keys.push_back(get_tag_key(tag));
+            }
+
+            // The script runs atomically, an invalidation either removes the new value or happens before it is written
+            std::future<cpp_redis::reply> reply = _client.eval(set_tagged_script, (int)keys.size(), keys,
+                { value, std::to_string(expire_seconds > 0 ? expire_seconds : 0) });
+            _client.sync_commit();
+
+            if (reply.get().is_error()) {
+                remove(key);
+            }
+        }
+#endif
+    }
+
+    void RedisBackend::invalidate_tag(const std::string& tag) {
+#ifdef HAS_FEATURE_CPPREDIS
+        if (_enabled && _client.is_connected()) {
+            std::future<cpp_redis::reply> reply = _client.eval(invalidate_tag_script, 1, { get_tag_key(tag) }, {});
+            _client.sync_commit();
+            reply.wait();
+        }
+#endif
+    }
+
+    const std::string RedisBackend::get_tag_key(const std::string& tag) const {
+        return "vortex.tags." + tag;
+    }
+
     CacheBackendInterface* get_redis_backend() {
         static RedisBackend instance;
         return &instance;
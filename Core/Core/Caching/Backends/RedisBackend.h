@@ -24,12 +24,19 @@ namespace Vortex::Core::Caching::Backends {
         virtual void remove(const std::string& key) override;
         virtual void set_expiry(const std::string& key, int seconds) override;
 
+        virtual void set_tags(const std::string& key, const std::vector<std::string>& tags) override;
+        virtual void invalidate_tag(const std::string& tag) override;
+        virtual void set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) override;
+
     private:
 #ifdef HAS_FEATURE_CPPREDIS
         cpp_redis::client _client;
 #endif
         Maze::Element _redis_config;
         bool _enabled = false;
+
+        // Set holding every key tagged with the tag
+        const std::string get_tag_key(const std::string& tag) const;
     };
 
 
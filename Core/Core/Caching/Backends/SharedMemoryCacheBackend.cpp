@@ -0,0 +1,628 @@
+#include <Core/Caching/Backends/SharedMemoryCacheBackend.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <new>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <Core/GlobalRuntime.h>
+#include <Core/Logging.h>
+
+namespace ipc = boost::interprocess;
+
+namespace Vortex::Core::Caching::Backends {
+
+    namespace {
+
+        const uint32_t smallest_block = 256;
+        // Buckets swept by the clock between allocation attempts when the segment is full
+        const uint32_t eviction_batch = 64;
+        const int lock_timeout_millis = 1000;
+
+        uint32_t block_size(uint32_t size_class) {
+            return smallest_block << size_class;
+        }
+
+        // Segment layout version, segments left behind by builds with another layout are not attached to
+        const char* header_name = "header_v2";
+        const char* buckets_name = "buckets_v2";
+
+        // Operations are skipped when the lock can't be taken in time (reads miss, writes are dropped).
+        // The repair runs when the previous holder of the lock crashed while holding it.
+        class SharedLock {
+        public:
+            explicit SharedLock(SharedCacheMutex& mtx, const std::function<void()>& repair = nullptr) : _mtx(mtx) {
+                const SharedCacheMutex::LockResult result = mtx.lock(lock_timeout_millis);
+
+                _locked = result != SharedCacheMutex::LockResult::TimedOut;
+
+                if (result == SharedCacheMutex::LockResult::OwnerDied) {
+                    VORTEX_WARN("Shared memory cache lock was held by a crashed process, repairing the data it guards");
+
+                    if (repair) {
+                        repair();
+                    }
+
+                    mtx.mark_consistent();
+                }
+                else if (!_locked) {
+                    VORTEX_ERROR("Shared memory cache lock timed out");
+                }
+            }
+
+            ~SharedLock() {
+                if (_locked) {
+                    _mtx.unlock();
+                }
+            }
+
+            SharedLock(const SharedLock&) = delete;
+            SharedLock& operator=(const SharedLock&) = delete;
+
+            explicit operator bool() const {
+                return _locked;
+            }
+
+        private:
+            SharedCacheMutex& _mtx;
+            bool _locked;
+        };
+
+        CacheCounterGroup& backend_statistics() {
+            static CacheCounterGroup& counters = GlobalRuntime::instance().cache().statistics().backend_group(shared_memory_cache_exports.backend_name);
+
+            return counters;
+        }
+
+    }  // namespace
+
+#ifdef __linux__
+    SharedCacheMutex::SharedCacheMutex() {
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&_mtx, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+    }
+
+    SharedCacheMutex::LockResult SharedCacheMutex::lock(int timeout_millis) {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_millis / 1000;
+        deadline.tv_nsec += (long)(timeout_millis % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        const int result = pthread_mutex_timedlock(&_mtx, &deadline);
+
+        if (result == 0) {
+            return LockResult::Locked;
+        }
+
+        return result == EOWNERDEAD ? LockResult::OwnerDied : LockResult::TimedOut;
+    }
+
+    void SharedCacheMutex::mark_consistent() {
+        pthread_mutex_consistent(&_mtx);
+    }
+
+    void SharedCacheMutex::unlock() {
+        pthread_mutex_unlock(&_mtx);
+    }
+#else
+    SharedCacheMutex::SharedCacheMutex() {}
+
+    SharedCacheMutex::LockResult SharedCacheMutex::lock(int timeout_millis) {
+        const bool locked = _mtx.timed_lock(boost::posix_time::microsec_clock::universal_time() +
+            boost::posix_time::milliseconds(timeout_millis));
+
+        return locked ? LockResult::Locked : LockResult::TimedOut;
+    }
+
+    void SharedCacheMutex::mark_consistent() {}
+
+    void SharedCacheMutex::unlock() {
+        _mtx.unlock();
+    }
+#endif
+
+    SharedCacheHeader::SharedCacheHeader(uint32_t bucket_count, uint32_t stripe_count, ipc::offset_ptr<SharedCacheEntry>* buckets)
+        : bucket_count(bucket_count), stripe_count(stripe_count), buckets(buckets), clock_hand(0) {
+        for (auto& slab_class : slab_classes) {
+            slab_class.free_list = nullptr;
+        }
+
+        for (auto& generation : tag_generations) {
+            generation.store(0);
+        }
+    }
+
+    SharedMemoryCacheBackend::SharedMemoryCacheBackend() {}
+
+    SharedMemoryCacheBackend::SharedMemoryCacheBackend(const Maze::Element& cache_config) {
+        set_config(cache_config);
+    }
+
+    // The segment is kept alive for the other processes, only this mapping is released
+    SharedMemoryCacheBackend::~SharedMemoryCacheBackend() {}
+
+    void SharedMemoryCacheBackend::connect() {
+        if (!_enabled || _segment) {
+            return;
+        }
+
+        try {
+            // Header and buckets are created by the first process, others attach to the existing ones
+            auto initialize_segment = [this]() {
+                _header = _segment->find<SharedCacheHeader>(header_name).first;
+
+                if (_header == nullptr) {
+                    ipc::offset_ptr<SharedCacheEntry>* buckets =
+                        _segment->construct<ipc::offset_ptr<SharedCacheEntry>>(buckets_name)[_bucket_count](nullptr);
+
+                    _header = _segment->construct<SharedCacheHeader>(header_name)(_bucket_count, _stripe_count, buckets);
+                }
+            };
+
+            // Locks held by crashed processes are recovered when they are next taken, so the segment is never
+            // recreated while other processes may still be attached to it
+            _segment = std::make_unique<ipc::managed_shared_memory>(ipc::open_or_create, _segment_name.c_str(), _segment_size);
+            _segment->atomic_func(initialize_segment);
+
+            VORTEX_INFO("Attached to shared memory cache {0} ({1} buckets, {2} bytes free)",
+                _segment_name, _header->bucket_count, _segment->get_free_memory());
+        }
+        catch (const ipc::interprocess_exception& e) {
+            VORTEX_ERROR("Unable to open shared memory cache {0}: {1}", _segment_name, e.what());
+
+            _segment.reset();
+            _header = nullptr;
+            _enabled = false;
+        }
+    }
+
+    void SharedMemoryCacheBackend::set_config(const Maze::Element& cache_config) {
+        _cache_config = cache_config;
+
+        if (_cache_config.is_bool("enabled")) {
+            _enabled = _cache_config["enabled"].get_bool();
+        }
+
+        if (_cache_config.is_string("segment_name")) {
+            _segment_name = _cache_config["segment_name"].get_string();
+        }
+
+        if (_cache_config.is_int("segment_size_mb") && _cache_config["segment_size_mb"].get_int() > 0) {
+            _segment_size = (size_t)_cache_config["segment_size_mb"].get_int() * 1024 * 1024;
+        }
+
+        if (_cache_config.is_int("bucket_count") && _cache_config["bucket_count"].get_int() > 0) {
+            _bucket_count = _cache_config["bucket_count"].get_int();
+        }
+
+        if (_cache_config.is_int("stripe_count") && _cache_config["stripe_count"].get_int() > 0) {
+            _stripe_count = std::min(_cache_config["stripe_count"].get_int(), shared_cache_max_stripes);
+        }
+    }
+
+    const bool SharedMemoryCacheBackend::is_enabled() const {
+        return _enabled;
+    }
+
+    const std::string SharedMemoryCacheBackend::get(const std::string& key) {
+        if (_enabled && _header != nullptr) {
+            const uint64_t hash = hash_value(key);
+            const uint32_t stripe_index = this->stripe_index(hash);
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+
+            SharedCacheEntry* entry = lock ? find_valid_entry(key, hash) : nullptr;
+            if (entry != nullptr) {
+                return std::string(entry->data() + entry->key_length, entry->value_length);
+            }
+        }
+
+        return "";
+    }
+
+    void SharedMemoryCacheBackend::set(const std::string& key, const std::string& value, int expire_seconds) {
+        store_entry(key, value, expire_seconds, {});
+    }
+
+    void SharedMemoryCacheBackend::store_entry(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+        if (_enabled && _header != nullptr) {
+            const uint64_t hash = hash_value(key);
+
+            // Tag generations are taken before the entry becomes visible, an invalidation in between makes it stale right away
+            SharedCacheTag entry_tags[shared_cache_max_tags];
+            uint32_t tag_count = 0;
+
+            for (const auto& tag : tags) {
+                const uint32_t slot = hash_value(tag) % shared_cache_tag_slots;
+
+                bool slot_exists = false;
+                for (uint32_t i = 0; i < tag_count; ++i) {
+                    slot_exists = slot_exists || entry_tags[i].slot == slot;
+                }
+
+                if (slot_exists) {
+                    continue;
+                }
+
+                // Entry that can not track all of its tags could outlive an invalidation, so it is not stored
+                if (tag_count == shared_cache_max_tags) {
+                    remove(key);
+
+                    return;
+                }
+
+                entry_tags[tag_count++] = SharedCacheTag{ slot, _header->tag_generations[slot].load() };
+            }
+
+            // Entry is filled before taking the stripe lock so the critical section stays short
+            SharedCacheEntry* entry = allocate_entry(key.length() + value.length());
+
+            // Segment is full, expired and invalidated entries are reclaimed and the clock evicts entries not used since its last pass
+            for (uint32_t swept = 0; entry == nullptr && swept < 2 * _header->bucket_count; swept += eviction_batch) {
+                reclaim(eviction_batch);
+                entry = allocate_entry(key.length() + value.length());
+            }
+
+            if (entry == nullptr) {
+                GlobalRuntime::instance().cache().statistics().record_set_failure(backend_statistics(), key);
+
+                return;
+            }
+
+            entry->hash = hash;
+            entry->expiry_timestamp = expire_seconds > 0 ? get_current_time_millis() + expire_seconds * (long long)1000 : 0;
+            entry->key_length = (uint32_t)key.length();
+            entry->value_length = (uint32_t)value.length();
+            entry->tag_count = tag_count;
+            entry->referenced = 1;
+            std::copy(entry_tags, entry_tags + tag_count, entry->tags);
+            std::memcpy(entry->data(), key.data(), key.length());
+            std::memcpy(entry->data() + key.length(), value.data(), value.length());
+
+            const uint32_t stripe_index = this->stripe_index(hash);
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+            if (!lock) {
+                free_entry(entry);
+                GlobalRuntime::instance().cache().statistics().record_set_failure(backend_statistics(), key);
+
+                return;
+            }
+
+            ipc::offset_ptr<SharedCacheEntry>* link = find_link(key, hash);
+            if (link != nullptr) {
+                remove_link(link);
+            }
+
+            // Stale entries of the same bucket are dropped while it is locked anyway
+            ipc::offset_ptr<SharedCacheEntry>* current = &bucket(hash);
+            while (*current) {
+                if (is_expired(current->get()) || is_invalidated(current->get())) {
+                    remove_link(current);
+                }
+                else {
+                    current = &(*current)->next;
+                }
+            }
+
+            entry->next = bucket(hash);
+            bucket(hash) = entry;
+        }
+    }
+
+    bool SharedMemoryCacheBackend::exists(const std::string& key) {
+        if (_enabled && _header != nullptr) {
+            const uint64_t hash = hash_value(key);
+            const uint32_t stripe_index = this->stripe_index(hash);
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+
+            return lock && find_valid_entry(key, hash) != nullptr;
+        }
+
+        return false;
+    }
+
+    void SharedMemoryCacheBackend::remove(const std::string& key) {
+        if (_enabled && _header != nullptr) {
+            const uint64_t hash = hash_value(key);
+            const uint32_t stripe_index = this->stripe_index(hash);
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+
+            ipc::offset_ptr<SharedCacheEntry>* link = lock ? find_link(key, hash) : nullptr;
+            if (link != nullptr) {
+                remove_link(link);
+            }
+        }
+    }
+
+    void SharedMemoryCacheBackend::set_expiry(const std::string& key, int seconds) {
+        if (_enabled && _header != nullptr) {
+            const uint64_t hash = hash_value(key);
+            const uint32_t stripe_index = this->stripe_index(hash);
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+
+            SharedCacheEntry* entry = lock ? find_valid_entry(key, hash) : nullptr;
+            if (entry != nullptr) {
+                entry->expiry_timestamp = seconds != 0 ? get_current_time_millis() + seconds * (long long)1000 : 0;
+            }
+        }
+    }
+
+    void SharedMemoryCacheBackend::set_tags(const std::string& key, const std::vector<std::string>& tags) {
+        if (_enabled && _header != nullptr) {
+            const uint64_t hash = hash_value(key);
+            const uint32_t stripe_index = this->stripe_index(hash);
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+
+            SharedCacheEntry* entry = lock ? find_valid_entry(key, hash) : nullptr;
+            if (entry == nullptr) {
+                return;
+            }
+
+            for (const auto& tag : tags) {
+                const uint32_t slot = hash_value(tag) % shared_cache_tag_slots;
+
+                bool slot_exists = false;
+                for (uint32_t i = 0; i < entry->tag_count; ++i) {
+                    slot_exists = slot_exists || entry->tags[i].slot == slot;
+                }
+
+                if (slot_exists) {
+                    continue;
+                }
+
+                // Entry that can not track all of its tags could outlive an invalidation, so it is dropped instead
+                if (entry->tag_count == shared_cache_max_tags) {
+                    remove_link(find_link(key, hash));
+
+                    return;
+                }
+
+                entry->tags[entry->tag_count++] = SharedCacheTag{ slot, _header->tag_generations[slot].load() };
+            }
+        }
+    }
+
+    void SharedMemoryCacheBackend::set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+        store_entry(key, value, expire_seconds, tags);
+    }
+
+    void SharedMemoryCacheBackend::invalidate_tag(const std::string& tag) {
+        if (_enabled && _header != nullptr) {
+            // Entries are removed lazily when they are accessed or their bucket is written to
+            _header->tag_generations[hash_value(tag) % shared_cache_tag_slots].fetch_add(1);
+        }
+    }
+
+    uint64_t SharedMemoryCacheBackend::hash_value(const std::string& value) {
+        // FNV-1a, std::hash is not guaranteed to match between processes built differently
+        uint64_t hash = 14695981039346656037ULL;
+
+        for (unsigned char c : value) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    uint32_t SharedMemoryCacheBackend::stripe_index(uint64_t hash) const {
+        return (uint32_t)((hash % _header->bucket_count) % _header->stripe_count);
+    }
+
+    ipc::offset_ptr<SharedCacheEntry>& SharedMemoryCacheBackend::bucket(uint64_t hash) const {
+        return _header->buckets[hash % _header->bucket_count];
+    }
+
+    ipc::offset_ptr<SharedCacheEntry>* SharedMemoryCacheBackend::find_link(const std::string& key, uint64_t hash) const {
+        ipc::offset_ptr<SharedCacheEntry>* link = &bucket(hash);
+
+        while (*link) {
+            SharedCacheEntry* entry = link->get();
+
+            if (entry->hash == hash && entry->key_length == key.length() &&
+                std::memcmp(entry->data(), key.data(), key.length()) == 0) {
+                return link;
+            }
+
+            link = &entry->next;
+        }
+
+        return nullptr;
+    }
+
+    SharedCacheEntry* SharedMemoryCacheBackend::find_valid_entry(const std::string& key, uint64_t hash) {
+        ipc::offset_ptr<SharedCacheEntry>* link = find_link(key, hash);
+        if (link == nullptr) {
+            return nullptr;
+        }
+
+        if (is_expired(link->get())) {
+            remove_link(link);
+            GlobalRuntime::instance().cache().statistics().record_expiration(backend_statistics(), key);
+
+            return nullptr;
+        }
+
+        if (is_invalidated(link->get())) {
+            remove_link(link);
+
+            return nullptr;
+        }
+
+        link->get()->referenced = 1;
+
+        return link->get();
+    }
+
+    void SharedMemoryCacheBackend::remove_link(ipc::offset_ptr<SharedCacheEntry>* link, bool release) {
+        SharedCacheEntry* entry = link->get();
+
+        *link = entry->next;
+        free_entry(entry, release);
+    }
+
+    bool SharedMemoryCacheBackend::is_expired(const SharedCacheEntry* entry) const {
+        return entry->expiry_timestamp != 0 && get_current_time_millis() >= entry->expiry_timestamp;
+    }
+
+    bool SharedMemoryCacheBackend::is_invalidated(const SharedCacheEntry* entry) const {
+        for (uint32_t i = 0; i < entry->tag_count; ++i) {
+            if (_header->tag_generations[entry->tags[i].slot].load() != entry->tags[i].generation) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    SharedCacheEntry* SharedMemoryCacheBackend::allocate_entry(size_t data_length) {
+        const size_t length = sizeof(SharedCacheEntry) + data_length;
+        SharedCacheEntry* entry = nullptr;
+
+        uint32_t size_class = 0;
+        while (size_class < shared_cache_size_classes && block_size(size_class) < length) {
+            ++size_class;
+        }
+
+        if (size_class == shared_cache_size_classes) {
+            entry = static_cast<SharedCacheEntry*>(_segment->allocate(length, std::nothrow));
+            size_class = shared_cache_large_block;
+        }
+        else {
+            SharedCacheSlabClass& slab_class = _header->slab_classes[size_class];
+
+            {
+                SharedLock lock(slab_class.mtx);
+
+                if (lock && slab_class.free_list) {
+                    entry = slab_class.free_list.get();
+                    slab_class.free_list = entry->next;
+                }
+            }
+
+            if (entry == nullptr) {
+                entry = static_cast<SharedCacheEntry*>(_segment->allocate(block_size(size_class), std::nothrow));
+            }
+        }
+
+        if (entry != nullptr) {
+            new (entry) SharedCacheEntry();
+            entry->size_class = size_class;
+        }
+
+        return entry;
+    }
+
+    void SharedMemoryCacheBackend::free_entry(SharedCacheEntry* entry, bool release) {
+        if (!release && entry->size_class != shared_cache_large_block) {
+            SharedCacheSlabClass& slab_class = _header->slab_classes[entry->size_class];
+            SharedLock lock(slab_class.mtx);
+
+            if (lock) {
+                entry->next = slab_class.free_list;
+                slab_class.free_list = entry;
+
+                return;
+            }
+        }
+
+        _segment->deallocate(entry);
+    }
+
+    void SharedMemoryCacheBackend::release_free_lists() {
+        for (auto& slab_class : _header->slab_classes) {
+            ipc::offset_ptr<SharedCacheEntry> free_list;
+
+            {
+                SharedLock lock(slab_class.mtx);
+                if (!lock) {
+                    continue;
+                }
+
+                free_list = slab_class.free_list;
+                slab_class.free_list = nullptr;
+            }
+
+            while (free_list) {
+                SharedCacheEntry* entry = free_list.get();
+                free_list = entry->next;
+
+                _segment->deallocate(entry);
+            }
+        }
+    }
+
+    void SharedMemoryCacheBackend::reclaim(uint32_t bucket_count) {
+        // Blocks kept for other size classes go back to the segment first
+        release_free_lists();
+
+        CacheStatistics& statistics = GlobalRuntime::instance().cache().statistics();
+
+        for (uint32_t i = 0; i < bucket_count; ++i) {
+            const uint32_t index = _header->clock_hand.fetch_add(1) % _header->bucket_count;
+
+            const uint32_t stripe_index = index % _header->stripe_count;
+            SharedLock lock(_header->stripes[stripe_index], [this, stripe_index]() { repair_stripe(stripe_index); });
+            if (!lock) {
+                continue;
+            }
+
+            ipc::offset_ptr<SharedCacheEntry>* current = &_header->buckets[index];
+            while (*current) {
+                SharedCacheEntry* entry = current->get();
+
+                if (is_expired(entry) || is_invalidated(entry)) {
+                    if (statistics.is_enabled()) {
+                        statistics.record_expiration(backend_statistics(), std::string(entry->data(), entry->key_length));
+                    }
+
+                    remove_link(current, true);
+                }
+                else if (entry->referenced) {
+                    // Used since the last pass, gets another chance
+                    entry->referenced = 0;
+                    current = &entry->next;
+                }
+                else {
+                    if (statistics.is_enabled()) {
+                        statistics.record_eviction(backend_statistics(), std::string(entry->data(), entry->key_length));
+                    }
+
+                    remove_link(current, true);
+                }
+            }
+        }
+    }
+
+    void SharedMemoryCacheBackend::repair_stripe(uint32_t stripe_index) {
+        // Links are only changed by single pointer writes so the chains are intact, but the entries may not be
+        // (like a tag count that was incremented before its tag was written). Blocks go back to the segment.
+        for (uint32_t index = stripe_index; index < _header->bucket_count; index += _header->stripe_count) {
+            ipc::offset_ptr<SharedCacheEntry>* head = &_header->buckets[index];
+
+            while (*head) {
+                remove_link(head, true);
+            }
+        }
+    }
+
+    long long SharedMemoryCacheBackend::get_current_time_millis() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>
+            (std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    CacheBackendInterface* get_shared_memory_cache_backend() {
+        static SharedMemoryCacheBackend instance;
+        return &instance;
+    }
+
+}
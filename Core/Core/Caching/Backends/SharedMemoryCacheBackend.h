@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <Core/Caching/Cache.h>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Caching::Backends {
+
+    const int shared_cache_max_stripes = 256;
+    const int shared_cache_max_tags = 16;
+    const int shared_cache_tag_slots = 4096;
+    // Slab size classes are powers of two from 256 bytes to 2 MB, larger values are allocated directly.
+    // Freed blocks stay in their class free list and are reused by entries of similar size,
+    // when the segment is full the free lists are returned to it and a clock sweep evicts entries.
+    const int shared_cache_size_classes = 14;
+    const uint32_t shared_cache_large_block = UINT32_MAX;
+
+
+    // Process shared mutex that survives a process which crashed while holding it.
+    // On Linux it is a robust pthread mutex, the next locker is told that the owner died, repairs the data
+    // guarded by the mutex and marks it consistent again, so recovery happens in place for every attached process.
+    // Elsewhere locks are given up after the timeout and the operation is skipped.
+    class SharedCacheMutex {
+    public:
+        enum class LockResult {
+            Locked,
+            // Locked, but the previous owner died while holding it and the guarded data has to be repaired
+            OwnerDied,
+            TimedOut
+        };
+
+        SharedCacheMutex();
+
+        SharedCacheMutex(const SharedCacheMutex&) = delete;
+        SharedCacheMutex& operator=(const SharedCacheMutex&) = delete;
+
+        LockResult lock(int timeout_millis);
+        // Called after the repair that follows LockResult::OwnerDied
+        void mark_consistent();
+        void unlock();
+
+    private:
+#ifdef __linux__
+        pthread_mutex_t _mtx;
+#else
+        boost::interprocess::interprocess_mutex _mtx;
+#endif
+    };
+
+
+    struct SharedCacheTag {
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+
+    // Entry header, key and value bytes follow it in the same block
+    struct SharedCacheEntry {
+        boost::interprocess::offset_ptr<SharedCacheEntry> next;
+        uint64_t hash;
+        int64_t expiry_timestamp;
+        uint32_t key_length;
+        uint32_t value_length;
+        uint32_t size_class;
+        uint32_t tag_count;
+        // Set when the entry is read, cleared by the clock sweep that evicts entries which were not read since
+        uint32_t referenced;
+        SharedCacheTag tags[shared_cache_max_tags];
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+
+    struct SharedCacheSlabClass {
+        SharedCacheMutex mtx;
+        boost::interprocess::offset_ptr<SharedCacheEntry> free_list;
+    };
+
+
+    // Lives at the start of the segment and is shared by every process
+    struct SharedCacheHeader {
+        SharedCacheHeader(uint32_t bucket_count, uint32_t stripe_count, boost::interprocess::offset_ptr<SharedCacheEntry>* buckets);
+
+        uint32_t bucket_count;
+        uint32_t stripe_count;
+        boost::interprocess::offset_ptr<boost::interprocess::offset_ptr<SharedCacheEntry>> buckets;
+        SharedCacheMutex stripes[shared_cache_max_stripes];
+        SharedCacheSlabClass slab_classes[shared_cache_size_classes];
+        // Invalidating a tag bumps its slot generation, entries with older generations are treated as missing
+        std::atomic<uint32_t> tag_generations[shared_cache_tag_slots];
+        std::atomic<uint32_t> clock_hand;
+    };
+
+
+    class SharedMemoryCacheBackend : public CacheBackendInterface {
+    public:
+        SharedMemoryCacheBackend();
+        SharedMemoryCacheBackend(const Maze::Element& cache_config);
+        ~SharedMemoryCacheBackend();
+
+        void connect();
+        void set_config(const Maze::Element& cache_config);
+        const bool is_enabled() const;
+
+        virtual const std::string get(const std::string& key) override;
+        virtual void set(const std::string& key, const std::string& value, int expire_seconds = 180) override;
+        virtual bool exists(const std::string& key) override;
+        virtual void remove(const std::string& key) override;
+        virtual void set_expiry(const std::string& key, int seconds) override;
+
+        virtual void set_tags(const std::string& key, const std::vector<std::string>& tags) override;
+        virtual void invalidate_tag(const std::string& tag) override;
+        virtual void set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) override;
+
+    private:
+        Maze::Element _cache_config;
+        bool _enabled = false;
+        std::string _segment_name = "vortex_cache";
+        size_t _segment_size = 64 * 1024 * 1024;
+        uint32_t _bucket_count = 16384;
+        uint32_t _stripe_count = 64;
+        std::unique_ptr<boost::interprocess::managed_shared_memory> _segment;
+        SharedCacheHeader* _header = nullptr;
+
+        static uint64_t hash_value(const std::string& value);
+
+        void store_entry(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags);
+
+        uint32_t stripe_index(uint64_t hash) const;
+        boost::interprocess::offset_ptr<SharedCacheEntry>& bucket(uint64_t hash) const;
+
+        // Link (bucket head or next pointer) that points to the entry, must be called with the stripe of the key locked
+        boost::interprocess::offset_ptr<SharedCacheEntry>* find_link(const std::string& key, uint64_t hash) const;
+        SharedCacheEntry* find_valid_entry(const std::string& key, uint64_t hash);
+        // Released blocks go back to the segment instead of the free list of their size class
+        void remove_link(boost::interprocess::offset_ptr<SharedCacheEntry>* link, bool release = false);
+        bool is_expired(const SharedCacheEntry* entry) const;
+        bool is_invalidated(const SharedCacheEntry* entry) const;
+
+        SharedCacheEntry* allocate_entry(size_t data_length);
+        void free_entry(SharedCacheEntry* entry, bool release = false);
+        void release_free_lists();
+        // Advances the clock over the given number of buckets
+        void reclaim(uint32_t bucket_count);
+        // Entries of a stripe whose lock holder crashed may be half written, they are dropped
+        void repair_stripe(uint32_t stripe_index);
+
+        long long get_current_time_millis() const;
+    };
+
+
+    CacheBackendInterface* get_shared_memory_cache_backend();
+
+
+    static const CacheBackendDetails shared_memory_cache_exports = {
+        "SharedMemoryCacheBackend",
+        "SharedMemoryCache",
+        get_shared_memory_cache_backend
+    };
+
+}  // namespace Vortex::Core::Caching::Backends
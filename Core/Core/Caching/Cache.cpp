@@ -1,15 +1,40 @@
 #include <Core/Caching/Cache.h>
+#include <chrono>
 #include <boost/thread/mutex.hpp>
 #include <Core/Exceptions/CacheException.h>
+#include <Core/GlobalRuntime.h>
 #include <Core/Logging.h>
+#include <Core/Util/Compression.h>
+#include <Core/Util/MessagePack.h>
 #ifdef HAS_FEATURE_CPPREDIS
 #include <Core/Caching/Backends/RedisBackend.h>
 #endif
+#include <Core/Caching/Backends/MemcachedBackend.h>
 #include <Core/Caching/Backends/MemoryCacheBackend.h>
+#include <Core/Caching/Backends/SharedMemoryCacheBackend.h>
 #include <Core/Caching/Backends/DummyCacheBackend.h>
 
 namespace Vortex::Core::Caching {
 
+    std::map<std::string, std::string> CacheBackendInterface::get_multi(const std::vector<std::string>& keys) {
+        std::map<std::string, std::string> values;
+
+        for (const auto& key : keys) {
+            std::string value = get(key);
+
+            if (!value.empty()) {
+                values[key] = value;
+            }
+        }
+
+        return values;
+    }
+
+    void CacheBackendInterface::set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) {
+        set(key, value, expire_seconds);
+        set_tags(key, tags);
+    }
+
     void Cache::initialize(const Maze::Element& cache_config) {
         static boost::mutex mtx;
 
@@ -43,6 +68,34 @@ namespace Vortex::Core::Caching {
                 _default_backend = Backends::memory_cache_exports.backend_name;
             }
 
+            Backends::MemcachedBackend* memcached_backend = static_cast<Backends::MemcachedBackend*>(Backends::memcached_exports.get_backend_instance());
+            memcached_backend->set_config(cache_config.get("config").get("Memcached"));
+
+            if (memcached_backend->is_enabled()) {
+                memcached_backend->connect();
+
+                _available_backends.push_back(std::make_pair<std::string, CacheBackendInterface*>(
+                    Backends::memcached_exports.backend_name,
+                    static_cast<CacheBackendInterface*>(memcached_backend)
+                    ));
+
+                _default_backend = Backends::memcached_exports.backend_name;
+            }
+
+            Backends::SharedMemoryCacheBackend* shared_memory_backend = static_cast<Backends::SharedMemoryCacheBackend*>(Backends::shared_memory_cache_exports.get_backend_instance());
+            shared_memory_backend->set_config(cache_config.get("config").get("SharedMemoryCache"));
+
+            if (shared_memory_backend->is_enabled()) {
+                shared_memory_backend->connect();
+
+                _available_backends.push_back(std::make_pair<std::string, CacheBackendInterface*>(
+                    Backends::shared_memory_cache_exports.backend_name,
+                    static_cast<CacheBackendInterface*>(shared_memory_backend)
+                    ));
+
+                _default_backend = Backends::shared_memory_cache_exports.backend_name;
+            }
+
 #ifdef HAS_FEATURE_CPPREDIS
             Backends::RedisBackend* redis_backend = static_cast<Backends::RedisBackend*>(Backends::redis_exports.get_backend_instance());
             redis_backend->set_config(cache_config.get("config").get("Redis"));
@@ -81,6 +134,47 @@ namespace Vortex::Core::Caching {
             VORTEX_INFO("Caching is disabled in configuration.");
         }
 
+        if (cache_config.is_int("object_expiry")) {
+            _object_expiry = cache_config["object_expiry"].get_int();
+        }
+
+        _backend_statistics = &_statistics.backend_group(_default_backend);
+        _statistics.set_config(cache_config.get("statistics", Maze::Type::Object));
+
+        for (const auto& backend : _available_backends) {
+            const Maze::Element compression_config = cache_config.get("config", Maze::Type::Object)
+                .get(backend.first, Maze::Type::Object).get("compression", Maze::Type::Object);
+            CacheCompressionSettings settings;
+
+            if (compression_config.is_bool("enabled")) {
+                settings.enabled = compression_config["enabled"].get_bool();
+            }
+            if (compression_config.is_int("threshold") && compression_config["threshold"].get_int() >= 0) {
+                settings.threshold = compression_config["threshold"].get_int();
+            }
+            if (compression_config.is_int("level")) {
+                settings.level = compression_config["level"].get_int();
+            }
+
+            if (settings.enabled && !Util::Compression::is_available()) {
+                VORTEX_WARN("Compression is enabled for cache backend {0} but zlib support is not available.", backend.first);
+                settings.enabled = false;
+            }
+
+            _compression_settings[backend.first] = settings;
+        }
+
+        if (cache_config.is_bool("binary_values")) {
+            _binary_values = cache_config["binary_values"].get_bool();
+        }
+
+        if (_change_subscription_id == 0) {
+            _change_subscription_id = GlobalRuntime::instance().storage().change_feed().subscribe(
+                [this](const std::string& database, const std::string& collection, Storage::ChangeType change) {
+                    invalidate_collection(database, collection);
+                });
+        }
+
         _initialized = true;
         mtx.unlock();
     }
@@ -90,25 +184,205 @@ namespace Vortex::Core::Caching {
     }
 
     const std::string Cache::get(const std::string& key) const {
-        return get_backend()->get(key);
+        if (!_statistics.is_enabled()) {
+            return decompress_value(key, get_backend()->get(key));
+        }
+
+        const auto begin_time = std::chrono::steady_clock::now();
+        const std::string value = get_backend()->get(key);
+
+        _statistics.record_get(*_backend_statistics, key, !value.empty(), value.length(), elapsed_micros(begin_time));
+
+        return decompress_value(key, value);
     }
 
-    void Cache::set(const std::string& key, const std::string& value, int expire_seconds) const {
-        get_backend()->set(key, value, expire_seconds);
+    std::map<std::string, std::string> Cache::get_multi(const std::vector<std::string>& keys) const {
+        const auto begin_time = std::chrono::steady_clock::now();
+        std::map<std::string, std::string> values = get_backend()->get_multi(keys);
+
+        if (_statistics.is_enabled()) {
+            const long long duration = elapsed_micros(begin_time) / (keys.empty() ? 1 : (long long)keys.size());
+
+            for (const auto& key : keys) {
+                const auto& it = values.find(key);
+
+                _statistics.record_get(*_backend_statistics, key, it != values.end(), it != values.end() ? it->second.length() : 0, duration);
+            }
+        }
+
+        for (auto it = values.begin(); it != values.end();) {
+            it->second = decompress_value(it->first, it->second);
+
+            if (it->second.empty()) {
+                it = values.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        return values;
+    }
+
+    void Cache::set(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags) const {
+        const std::string stored_value = compress_value(key, value);
+        const auto begin_time = std::chrono::steady_clock::now();
+        CacheBackendInterface* backend = get_backend();
+
+        if (tags.empty()) {
+            backend->set(key, stored_value, expire_seconds);
+        }
+        else {
+            backend->set_tagged(key, stored_value, expire_seconds, tags);
+        }
+
+        if (_statistics.is_enabled()) {
+            _statistics.record_set(*_backend_statistics, key, stored_value.length(), elapsed_micros(begin_time));
+        }
     }
 
     bool Cache::exists(const std::string& key) const {
-        return get_backend()->exists(key);
+        bool key_exists = get_backend()->exists(key);
+
+        // Existing keys are counted as hits by the get() that follows
+        if (!key_exists && _statistics.is_enabled()) {
+            _statistics.record_miss(*_backend_statistics, key);
+        }
+
+        return key_exists;
     }
 
     void Cache::remove(const std::string& key) const {
         get_backend()->remove(key);
+
+        if (_statistics.is_enabled()) {
+            _statistics.record_remove(*_backend_statistics, key);
+        }
     }
 
     void Cache::set_expiry(const std::string& key, int seconds) const {
         get_backend()->set_expiry(key, seconds);
     }
 
+    void Cache::invalidate_tag(const std::string& tag) const {
+        get_backend()->invalidate_tag(tag);
+    }
+
+    Maze::Element Cache::get_element(const std::string& key) const {
+        const std::string value = get(key);
+
+        if (value.empty()) {
+            return Maze::Element::get_null_element();
+        }
+
+        try {
+            if (Util::MessagePack::is_encoded(value)) {
+                return Util::MessagePack::decode(value);
+            }
+
+            return Maze::Element::from_json(value);
+        }
+        catch (...) {
+            VORTEX_WARN("Removing unreadable cache value {0}", key);
+            remove(key);
+
+            return Maze::Element::get_null_element();
+        }
+    }
+
+    void Cache::set_element(const std::string& key, const Maze::Element& value, int expire_seconds, const std::vector<std::string>& tags) const {
+        set(key, _binary_values ? Util::MessagePack::encode(value) : value.to_json(0), expire_seconds, tags);
+    }
+
+    CacheStatistics& Cache::statistics() const {
+        return _statistics;
+    }
+
+    const CacheCompressionSettings& Cache::compression_settings() const {
+        static const CacheCompressionSettings disabled_settings;
+
+        const auto& it = _compression_settings.find(_default_backend);
+
+        return it != _compression_settings.end() ? it->second : disabled_settings;
+    }
+
+    const std::string Cache::compress_value(const std::string& key, const std::string& value) const {
+        const CacheCompressionSettings& settings = compression_settings();
+
+        if (!settings.enabled || value.length() < settings.threshold) {
+            return value;
+        }
+
+        const auto begin_time = std::chrono::steady_clock::now();
+        const std::string compressed_value = Util::Compression::compress(value, settings.level);
+
+        _statistics.record_compression(*_backend_statistics, key, value.length(), compressed_value.length(), elapsed_micros(begin_time));
+
+        // Values that do not shrink are stored as they are
+        return compressed_value.length() < value.length() ? compressed_value : value;
+    }
+
+    const std::string Cache::decompress_value(const std::string& key, const std::string& value) const {
+        if (!Util::Compression::is_compressed(value)) {
+            return value;
+        }
+
+        try {
+            const auto begin_time = std::chrono::steady_clock::now();
+            const std::string decompressed_value = Util::Compression::decompress(value);
+
+            _statistics.record_decompression(*_backend_statistics, key, elapsed_micros(begin_time));
+
+            return decompressed_value;
+        }
+        catch (const std::exception& e) {
+            VORTEX_WARN("Removing unreadable cache value {0}: {1}", key, e.what());
+            remove(key);
+
+            return "";
+        }
+    }
+
+    long long Cache::elapsed_micros(const std::chrono::steady_clock::time_point& begin_time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin_time).count();
+    }
+
+    const int Cache::object_expiry() const {
+        return _object_expiry;
+    }
+
+    void Cache::invalidate_collection(const std::string& database, const std::string& collection) const {
+        if (!_initialized) {
+            return;
+        }
+
+        // Empty collection name invalidates every collection of the database
+        invalidate_tag(collection.empty() ? database_tag(database) : collection_tag(database, collection));
+    }
+
+    const std::string Cache::collection_tag(const std::string& database, const std::string& collection) {
+        return "collection:" + database + "." + collection;
+    }
+
+    const std::string Cache::database_tag(const std::string& database) {
+        return "database:" + database;
+    }
+
+    const std::string Cache::application_tag(const std::string& application_id) {
+        return "app:" + application_id;
+    }
+
+    std::vector<std::string> Cache::collection_tags(const std::vector<std::string>& databases, const std::string& collection) {
+        std::vector<std::string> tags;
+
+        for (const auto& database : databases) {
+            tags.push_back(collection_tag(database, collection));
+            tags.push_back(database_tag(database));
+        }
+
+        return tags;
+    }
+
     CacheBackendInterface* Cache::get_backend() const {
         return get_backend(_default_backend);
     }
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <map>
 #include <string>
 #include <vector>
 #include <Maze/Maze.hpp>
 #include <Core/DLLSupport.h>
+#include <Core/Caching/CacheStatistics.h>
 
 namespace Vortex::Core::Caching {
 
@@ -16,12 +19,29 @@ namespace Vortex::Core::Caching {
         VORTEX_CORE_API virtual bool exists(const std::string& key) = 0;
         VORTEX_CORE_API virtual void remove(const std::string& key) = 0;
         VORTEX_CORE_API virtual void set_expiry(const std::string& key, int seconds) = 0;
+
+        VORTEX_CORE_API virtual void set_tags(const std::string& key, const std::vector<std::string>& tags) = 0;
+        VORTEX_CORE_API virtual void invalidate_tag(const std::string& tag) = 0;
+        // Stores the value together with its tags so a concurrent invalidation of one of the tags can't miss it.
+        // Backends without atomic tagging fall back to set() followed by set_tags().
+        VORTEX_CORE_API virtual void set_tagged(const std::string& key, const std::string& value, int expire_seconds, const std::vector<std::string>& tags);
+
+        // Only existing keys are returned. Backends without batched reads fall back to single gets.
+        VORTEX_CORE_API virtual std::map<std::string, std::string> get_multi(const std::vector<std::string>& keys);
     };
 
 
     typedef CacheBackendInterface* (*GetCacheBackendInstanceFunction)();
 
 
+    // Read from the compression object of each backend config
+    struct CacheCompressionSettings {
+        bool enabled = false;
+        size_t threshold = 16384;
+        int level = 6;
+    };
+
+
     struct VORTEX_CORE_API CacheBackendDetails {
         const char* class_name;
         const char* backend_name;
@@ -35,19 +55,53 @@ namespace Vortex::Core::Caching {
         VORTEX_CORE_API const bool is_initialized() const;
 
         VORTEX_CORE_API const std::string get(const std::string& key) const;
-        VORTEX_CORE_API void set(const std::string& key, const std::string& value, int expire_seconds = 180) const;
+        VORTEX_CORE_API std::map<std::string, std::string> get_multi(const std::vector<std::string>& keys) const;
+        VORTEX_CORE_API void set(const std::string& key, const std::string& value, int expire_seconds = 180, const std::vector<std::string>& tags = {}) const;
         VORTEX_CORE_API bool exists(const std::string& key) const;
         VORTEX_CORE_API void remove(const std::string& key) const;
         VORTEX_CORE_API void set_expiry(const std::string& key, int seconds) const;
+        VORTEX_CORE_API void invalidate_tag(const std::string& tag) const;
+
+        // Structured values are stored in binary (MessagePack) form unless binary_values is disabled.
+        // get_element also accepts json values and returns a null element when the key does not exist.
+        VORTEX_CORE_API Maze::Element get_element(const std::string& key) const;
+        VORTEX_CORE_API void set_element(const std::string& key, const Maze::Element& value, int expire_seconds = 180, const std::vector<std::string>& tags = {}) const;
 
         VORTEX_CORE_API CacheBackendInterface* get_backend() const;
         VORTEX_CORE_API CacheBackendInterface* get_backend(const std::string& backend_name) const;
 
+        // Counters are always recorded against the default backend
+        VORTEX_CORE_API CacheStatistics& statistics() const;
+
+        // Expiry used for runtime objects (hosts, applications, controllers, ...). 0 keeps them until invalidated.
+        VORTEX_CORE_API const int object_expiry() const;
+
+        VORTEX_CORE_API void invalidate_collection(const std::string& database, const std::string& collection) const;
+
+        VORTEX_CORE_API static const std::string collection_tag(const std::string& database, const std::string& collection);
+        VORTEX_CORE_API static const std::string database_tag(const std::string& database);
+        VORTEX_CORE_API static const std::string application_tag(const std::string& application_id);
+        // Collection and database tags for every database the value could have been loaded from
+        VORTEX_CORE_API static std::vector<std::string> collection_tags(const std::vector<std::string>& databases, const std::string& collection);
+
     private:
         std::vector<std::pair<std::string, CacheBackendInterface*>> _available_backends;
         std::string _default_backend;
         Maze::Element _cache_config;
         bool _initialized = false;
+        int _object_expiry = 180;
+        bool _binary_values = true;
+        int _change_subscription_id = 0;
+        mutable CacheStatistics _statistics;
+        // Counters of the default backend, resolved when it is selected
+        CacheCounterGroup* _backend_statistics = nullptr;
+        std::map<std::string, CacheCompressionSettings> _compression_settings;
+
+        const CacheCompressionSettings& compression_settings() const;
+        const std::string compress_value(const std::string& key, const std::string& value) const;
+        const std::string decompress_value(const std::string& key, const std::string& value) const;
+
+        static long long elapsed_micros(const std::chrono::steady_clock::time_point& begin_time);
     };
 
 }  // namespace Vortex::Core::Caching
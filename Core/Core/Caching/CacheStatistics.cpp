@@ -0,0 +1,322 @@
+#include <Core/Caching/CacheStatistics.h>
+#include <functional>
+#include <mutex>
+
+namespace Vortex::Core::Caching {
+
+    namespace {
+
+        const std::string other_prefix = "(other)";
+
+        // Thread ids are aligned pointers on some platforms, hashing them would put most threads on the same stripe
+        std::atomic<size_t> next_stripe{ 0 };
+
+        size_t current_stripe() {
+            static thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % CacheCounterGroup::stripe_count;
+
+            return stripe;
+        }
+
+        std::atomic<uint64_t> next_instance_id{ 1 };
+
+        // Prefix groups are never removed, so their addresses can be cached without holding the lock.
+        // Prefixes beyond max_prefixes share the other group, the cache is cleared before those could grow it without bound.
+        struct PrefixGroupCache {
+            uint64_t instance_id = 0;
+            std::map<std::string, CacheCounterGroup*, std::less<>> groups;
+        };
+
+        thread_local PrefixGroupCache prefix_group_cache;
+
+        Maze::Element counter_element(uint64_t value) {
+            // Maze only has 32-bit integers
+            if (value <= INT32_MAX) {
+                return Maze::Element((int)value);
+            }
+
+            return Maze::Element((double)value);
+        }
+
+    }  // namespace
+
+    void CacheCounterGroup::add(int counter, uint64_t value) {
+        _stripes[current_stripe()].values[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t CacheCounterGroup::total(int counter) const {
+        uint64_t value = 0;
+
+        for (const auto& stripe : _stripes) {
+            value += stripe.values[counter].load(std::memory_order_relaxed);
+        }
+
+        return value;
+    }
+
+    void CacheCounterGroup::reset() {
+        for (auto& stripe : _stripes) {
+            for (auto& value : stripe.values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    CacheStatistics::CacheStatistics() : _instance_id(next_instance_id.fetch_add(1)) {}
+
+    void CacheStatistics::set_config(const Maze::Element& statistics_config) {
+        if (statistics_config.is_bool("enabled")) {
+            _enabled = statistics_config["enabled"].get_bool();
+        }
+
+        if (statistics_config.is_int("prefix_depth") && statistics_config["prefix_depth"].get_int() > 0) {
+            _prefix_depth = statistics_config["prefix_depth"].get_int();
+        }
+
+        if (statistics_config.is_int("max_prefixes") && statistics_config["max_prefixes"].get_int() > 0) {
+            _max_prefixes = statistics_config["max_prefixes"].get_int();
+        }
+    }
+
+    const bool CacheStatistics::is_enabled() const {
+        return _enabled;
+    }
+
+    CacheCounterGroup& CacheStatistics::backend_group(const std::string& backend) {
+        return group(_backends, backend, SIZE_MAX);
+    }
+
+    void CacheStatistics::record_get(CacheCounterGroup& backend, const std::string& key, bool hit, size_t bytes, long long duration_micros) {
+        if (!_enabled) {
+            return;
+        }
+
+        const int bucket = GetLatency + latency_bucket(duration_micros);
+
+        for (CacheCounterGroup* counters : { &backend, &prefix_group(key) }) {
+            counters->add(hit ? Hits : Misses);
+            counters->add(BytesRead, bytes);
+            counters->add(bucket);
+        }
+    }
+
+    void CacheStatistics::record_set(CacheCounterGroup& backend, const std::string& key, size_t bytes, long long duration_micros) {
+        if (!_enabled) {
+            return;
+        }
+
+        const int bucket = SetLatency + latency_bucket(duration_micros);
+
+        for (CacheCounterGroup* counters : { &backend, &prefix_group(key) }) {
+            counters->add(Sets);
+            counters->add(BytesWritten, bytes);
+            counters->add(bucket);
+        }
+    }
+
+    void CacheStatistics::record_set_failure(CacheCounterGroup& backend, const std::string& key) {
+        record(backend, key, SetFailures);
+    }
+
+    void CacheStatistics::record_remove(CacheCounterGroup& backend, const std::string& key) {
+        record(backend, key, Removes);
+    }
+
+    void CacheStatistics::record_miss(CacheCounterGroup& backend, const std::string& key) {
+        record(backend, key, Misses);
+    }
+
+    void CacheStatistics::record_eviction(CacheCounterGroup& backend, const std::string& key) {
+        record(backend, key, Evictions);
+    }
+
+    void CacheStatistics::record_expiration(CacheCounterGroup& backend, const std::string& key) {
+        record(backend, key, Expirations);
+    }
+
+    void CacheStatistics::record_compression(CacheCounterGroup& backend, const std::string& key, size_t original_bytes, size_t compressed_bytes, long long duration_micros) {
+        if (!_enabled) {
+            return;
+        }
+
+        for (CacheCounterGroup* counters : { &backend, &prefix_group(key) }) {
+            counters->add(CompressedValues);
+            counters->add(UncompressedBytes, original_bytes);
+            counters->add(CompressedBytes, compressed_bytes);
+            counters->add(CompressionMicros, duration_micros);
+        }
+    }
+
+    void CacheStatistics::record_decompression(CacheCounterGroup& backend, const std::string& key, long long duration_micros) {
+        record(backend, key, DecompressionMicros, duration_micros);
+    }
+
+    Maze::Element CacheStatistics::snapshot() const {
+        Maze::Element result(Maze::Type::Object);
+        Maze::Element backends(Maze::Type::Object);
+        Maze::Element prefixes(Maze::Type::Object);
+
+        std::shared_lock<std::shared_mutex> lock(_mtx);
+
+        for (const auto& backend : _backends) {
+            backends.set(backend.first, group_snapshot(*backend.second));
+        }
+
+        for (const auto& prefix : _prefixes) {
+            prefixes.set(prefix.first, group_snapshot(*prefix.second));
+        }
+
+        result.set("enabled", _enabled);
+        result.set("backends", backends);
+        result.set("prefixes", prefixes);
+
+        return result;
+    }
+
+    void CacheStatistics::reset() {
+        std::shared_lock<std::shared_mutex> lock(_mtx);
+
+        for (auto& backend : _backends) {
+            backend.second->reset();
+        }
+
+        for (auto& prefix : _prefixes) {
+            prefix.second->reset();
+        }
+    }
+
+    const std::string CacheStatistics::key_prefix(const std::string& key) const {
+        return std::string(key_prefix_view(key));
+    }
+
+    std::string_view CacheStatistics::key_prefix_view(const std::string& key) const {
+        size_t position = 0;
+
+        for (int i = 0; i < _prefix_depth; ++i) {
+            position = key.find('.', position);
+
+            if (position == std::string::npos) {
+                return key;
+            }
+
+            ++position;
+        }
+
+        return std::string_view(key).substr(0, position - 1);
+    }
+
+    void CacheStatistics::record(CacheCounterGroup& backend, const std::string& key, int counter, uint64_t value) {
+        if (!_enabled) {
+            return;
+        }
+
+        backend.add(counter, value);
+        prefix_group(key).add(counter, value);
+    }
+
+    CacheCounterGroup& CacheStatistics::prefix_group(const std::string& key) {
+        PrefixGroupCache& cache = prefix_group_cache;
+
+        if (cache.instance_id != _instance_id) {
+            cache.groups.clear();
+            cache.instance_id = _instance_id;
+        }
+
+        const std::string_view prefix = key_prefix_view(key);
+
+        const auto& it = cache.groups.find(prefix);
+        if (it != cache.groups.end()) {
+            return *it->second;
+        }
+
+        CacheCounterGroup& counters = group(_prefixes, std::string(prefix), _max_prefixes);
+
+        if (cache.groups.size() >= _max_prefixes * 4) {
+            cache.groups.clear();
+        }
+        cache.groups.emplace(prefix, &counters);
+
+        return counters;
+    }
+
+    CacheCounterGroup& CacheStatistics::group(CounterGroupMap& groups, const std::string& name, size_t max_groups) {
+        {
+            std::shared_lock<std::shared_mutex> lock(_mtx);
+
+            const auto& it = groups.find(name);
+            if (it != groups.end()) {
+                return *it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_mtx);
+
+        // Keys with unbounded prefixes would otherwise grow the map forever
+        const std::string& group_name = groups.size() < max_groups ? name : other_prefix;
+
+        std::unique_ptr<CacheCounterGroup>& counters = groups[group_name];
+        if (!counters) {
+            counters = std::make_unique<CacheCounterGroup>();
+        }
+
+        return *counters;
+    }
+
+    int CacheStatistics::latency_bucket(long long duration_micros) {
+        int bucket = 0;
+
+        while (duration_micros > 1 && bucket < cache_latency_buckets - 1) {
+            duration_micros >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+
+    Maze::Element CacheStatistics::group_snapshot(const CacheCounterGroup& group) {
+        Maze::Element result(Maze::Type::Object);
+
+        const uint64_t hits = group.total(Hits);
+        const uint64_t misses = group.total(Misses);
+
+        result.set("hits", counter_element(hits));
+        result.set("misses", counter_element(misses));
+        result.set("hit_ratio", hits + misses > 0 ? (double)hits / (hits + misses) : 0.0);
+        result.set("sets", counter_element(group.total(Sets)));
+        result.set("set_failures", counter_element(group.total(SetFailures)));
+        result.set("removes", counter_element(group.total(Removes)));
+        result.set("evictions", counter_element(group.total(Evictions)));
+        result.set("expirations", counter_element(group.total(Expirations)));
+        result.set("bytes_read", counter_element(group.total(BytesRead)));
+        result.set("bytes_written", counter_element(group.total(BytesWritten)));
+
+        const uint64_t uncompressed_bytes = group.total(UncompressedBytes);
+        const uint64_t compressed_bytes = group.total(CompressedBytes);
+
+        Maze::Element compression(Maze::Type::Object);
+        compression.set("values", counter_element(group.total(CompressedValues)));
+        compression.set("uncompressed_bytes", counter_element(uncompressed_bytes));
+        compression.set("compressed_bytes", counter_element(compressed_bytes));
+        compression.set("ratio", compressed_bytes > 0 ? (double)uncompressed_bytes / compressed_bytes : 0.0);
+        compression.set("compression_us", counter_element(group.total(CompressionMicros)));
+        compression.set("decompression_us", counter_element(group.total(DecompressionMicros)));
+        result.set("compression", compression);
+
+        // Histogram buckets are keyed by their (exclusive) upper bound in microseconds
+        for (const auto& histogram : { std::make_pair("get_latency_us", (int)GetLatency), std::make_pair("set_latency_us", (int)SetLatency) }) {
+            Maze::Element buckets(Maze::Type::Object);
+
+            for (int i = 0; i < cache_latency_buckets; ++i) {
+                const uint64_t count = group.total(histogram.second + i);
+
+                if (count > 0) {
+                    buckets.set(std::to_string(1LL << (i + 1)), counter_element(count));
+                }
+            }
+
+            result.set(histogram.first, buckets);
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Caching {
+
+    // Latency histogram buckets, bucket i counts operations faster than 2^(i+1) microseconds
+    const int cache_latency_buckets = 24;
+
+
+    enum CacheCounter {
+        Hits = 0,
+        Misses,
+        Sets,
+        Removes,
+        Evictions,
+        Expirations,
+        SetFailures,
+        BytesRead,
+        BytesWritten,
+        CompressedValues,
+        UncompressedBytes,
+        CompressedBytes,
+        CompressionMicros,
+        DecompressionMicros,
+        GetLatency,
+        SetLatency = GetLatency + cache_latency_buckets,
+        CounterCount = SetLatency + cache_latency_buckets
+    };
+
+
+    // Counters are split into stripes so threads mostly increment their own cache line.
+    // Threads are assigned to stripes round robin when they first record something.
+    class CacheCounterGroup {
+    public:
+        static const int stripe_count = 8;
+
+        void add(int counter, uint64_t value = 1);
+        uint64_t total(int counter) const;
+        void reset();
+
+    private:
+        struct alignas(64) Stripe {
+            std::array<std::atomic<uint64_t>, CounterCount> values{};
+        };
+
+        std::array<Stripe, stripe_count> _stripes;
+    };
+
+
+    // Per backend and per key prefix counters of the cache operations, disabled unless statistics.enabled is set.
+    // Key prefix is made of the first prefix_depth dot separated key segments (vortex.core.template.value, ...).
+    // Backend counters are resolved once with backend_group(), prefix counters are cached per thread.
+    class CacheStatistics {
+    public:
+        VORTEX_CORE_API CacheStatistics();
+
+        VORTEX_CORE_API void set_config(const Maze::Element& statistics_config);
+        VORTEX_CORE_API const bool is_enabled() const;
+
+        // Returned group stays valid for the lifetime of the statistics
+        VORTEX_CORE_API CacheCounterGroup& backend_group(const std::string& backend);
+
+        VORTEX_CORE_API void record_get(CacheCounterGroup& backend, const std::string& key, bool hit, size_t bytes, long long duration_micros);
+        VORTEX_CORE_API void record_set(CacheCounterGroup& backend, const std::string& key, size_t bytes, long long duration_micros);
+        // Value could not be stored, for example because the backend ran out of memory
+        VORTEX_CORE_API void record_set_failure(CacheCounterGroup& backend, const std::string& key);
+        VORTEX_CORE_API void record_remove(CacheCounterGroup& backend, const std::string& key);
+        VORTEX_CORE_API void record_miss(CacheCounterGroup& backend, const std::string& key);
+        VORTEX_CORE_API void record_eviction(CacheCounterGroup& backend, const std::string& key);
+        VORTEX_CORE_API void record_expiration(CacheCounterGroup& backend, const std::string& key);
+        VORTEX_CORE_API void record_compression(CacheCounterGroup& backend, const std::string& key, size_t original_bytes, size_t compressed_bytes, long long duration_micros);
+        VORTEX_CORE_API void record_decompression(CacheCounterGroup& backend, const std::string& key, long long duration_micros);
+
+        VORTEX_CORE_API Maze::Element snapshot() const;
+        VORTEX_CORE_API void reset();
+
+        VORTEX_CORE_API const std::string key_prefix(const std::string& key) const;
+
+    private:
+        typedef std::map<std::string, std::unique_ptr<CacheCounterGroup>> CounterGroupMap;
+
+        bool _enabled = false;
+        int _prefix_depth = 4;
+        size_t _max_prefixes = 64;
+        CounterGroupMap _backends;
+        CounterGroupMap _prefixes;
+        mutable std::shared_mutex _mtx;
+        // Distinguishes the per thread prefix caches of different instances
+        const uint64_t _instance_id;
+
+        void record(CacheCounterGroup& backend, const std::string& key, int counter, uint64_t value = 1);
+        std::string_view key_prefix_view(const std::string& key) const;
+        CacheCounterGroup& prefix_group(const std::string& key);
+        CacheCounterGroup& group(CounterGroupMap& groups, const std::string& name, size_t max_groups);
+        static int latency_bucket(long long duration_micros);
+        static Maze::Element group_snapshot(const CacheCounterGroup& group);
+    };
+
+}  // namespace Vortex::Core::Caching
@@ -0,0 +1,253 @@
+#include <Core/Caching/CacheWarmup.h>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <Core/GlobalRuntime.h>
+#include <Core/Logging.h>
+
+namespace Vortex::Core::Caching {
+
+    namespace {
+
+        typedef std::shared_future<Maze::Element> CollectionFuture;
+
+        std::string get_object_id(const Maze::Element& value) {
+            if (value.is_object("_id") && value["_id"].is_string("$oid")) {
+                return value["_id"]["$oid"].get_string();
+            }
+
+            return "";
+        }
+
+        CollectionFuture load_collection(boost::asio::thread_pool& pool, const std::string& database, const std::string& collection, bool check_exists) {
+            auto task = std::make_shared<std::packaged_task<Maze::Element()>>([database, collection, check_exists]() {
+                Storage::StorageBackendInterface* backend = GlobalRuntime::instance().storage().get_backend();
+
+                if (check_exists && !backend->collection_exists(database, collection)) {
+                    return Maze::Element(Maze::Type::Array);
+                }
+
+                return backend->find_all_documents(database, collection, Maze::Element(Maze::Type::Object));
+                });
+
+            CollectionFuture future = task->get_future().share();
+            boost::asio::post(pool, [task]() { (*task)(); });
+
+            return future;
+        }
+
+    }  // namespace
+
+    CacheWarmup::CacheWarmup(const Maze::Element& config)
+        : _config(config) {
+        const Maze::Element& warmup_config = config.get_const_ref("warmup", Maze::Type::Object);
+
+        if (warmup_config.is_int("thread_count") && warmup_config["thread_count"].get_int() > 0) {
+            _thread_count = warmup_config["thread_count"].get_int();
+        }
+    }
+
+    const CacheWarmupResult CacheWarmup::run() {
+        const auto begin_time = std::chrono::steady_clock::now();
+        const Cache& cache = GlobalRuntime::instance().cache();
+        int loaded_entries = 0;
+
+        boost::asio::thread_pool pool(_thread_count);
+
+        CollectionFuture hosts_future = load_collection(pool, "vortex", "hosts", false);
+        CollectionFuture apps_future = load_collection(pool, "vortex", "apps", false);
+
+        const Maze::Element hosts = hosts_future.get();
+
+        for (const auto& host : hosts) {
+            if (host.is_string("hostname") && host.has_children()) {
+                const std::string cache_key = "vortex.core.host.value." + host["hostname"].get_string();
+
+                cache.set_element(cache_key, host, cache.object_expiry(),
+                    { Cache::collection_tag("vortex", "hosts"), Cache::database_tag("vortex") });
+                ++loaded_entries;
+            }
+        }
+
+        const Maze::Element apps = apps_future.get();
+        const std::string object_collections[] = { "controllers", "templates", "pages" };
+
+        // Databases of every application as resolved by the runtime for the hosts serving it. Object cache keys
+        // don't include the database, so applications whose hosts resolve to different databases are not warmed.
+        std::map<std::string, std::vector<std::string>> app_databases;
+
+        for (const auto& app : apps) {
+            const std::string app_id = get_object_id(app);
+            std::vector<std::string> databases;
+            bool has_host = false;
+            bool is_ambiguous = false;
+
+            for (const auto& host : hosts) {
+                if (!host.is_string("app_id") || host["app_id"].get_string() != app_id) {
+                    continue;
+                }
+
+                const std::vector<std::string> host_databases = application_databases(app, host);
+
+                if (!has_host) {
+                    databases = host_databases;
+                    has_host = true;
+                }
+                else if (host_databases != databases) {
+                    is_ambiguous = true;
+                }
+            }
+
+            if (!has_host) {
+                databases = application_databases(app, Maze::Element(Maze::Type::Object));
+            }
+
+            if (is_ambiguous) {
+                VORTEX_WARN("Cache warm-up skips objects of application {0}, its hosts use different databases", app_id);
+                databases.clear();
+            }
+
+            app_databases[app_id] = databases;
+        }
+
+        // Every (database, collection) pair is only loaded once, even when it is shared between applications
+        std::map<std::string, CollectionFuture> collection_futures;
+
+        for (const auto& app : apps) {
+            for (const auto& database : app_databases[get_object_id(app)]) {
+                for (const auto& collection : object_collections) {
+                    const std::string location = database + "." + collection;
+
+                    if (collection_futures.find(location) == collection_futures.end()) {
+                        collection_futures[location] = load_collection(pool, database, collection, database != "vortex");
+                    }
+                }
+            }
+        }
+
+        for (const auto& app : apps) {
+            const std::string app_id = get_object_id(app);
+
+            if (app_id.empty()) {
+                continue;
+            }
+
+            const std::string app_cache_key = "vortex.core.application.value." + app_id;
+
+            cache.set_element(app_cache_key, app, cache.object_expiry(),
+                { Cache::collection_tag("vortex", "apps"), Cache::database_tag("vortex"), Cache::application_tag(app_id) });
+            ++loaded_entries;
+
+            const std::vector<std::string>& databases = app_databases[app_id];
+
+            // Controllers are matched by app_id or by a missing app_id, whichever comes first
+            std::map<std::string, bool> loaded_controllers;
+            for (const auto& database : databases) {
+                for (const auto& controller : collection_futures[database + ".controllers"].get()) {
+                    if (!controller.is_string("name") || !controller.is_string("method")) {
+                        continue;
+                    }
+
+                    if (controller.exists("app_id") && !controller["app_id"].is_null() &&
+                        !(controller.is_string("app_id") && controller["app_id"].get_string() == app_id)) {
+                        continue;
+                    }
+
+                    const std::string cache_key = "vortex.core.controller.value." + app_id + "." +
+                        controller["name"].get_string() + "." + controller["method"].get_string();
+
+                    if (!loaded_controllers[cache_key]) {
+                        std::vector<std::string> tags = Cache::collection_tags(databases, "controllers");
+                        tags.push_back(Cache::application_tag(app_id));
+
+                        cache.set_element(cache_key, controller, cache.object_expiry(), tags);
+                        loaded_controllers[cache_key] = true;
+                        ++loaded_entries;
+                    }
+                }
+            }
+
+            // Templates and pages prefer application specific objects over shared ones
+            for (const std::string object_type : { "template", "page" }) {
+                std::map<std::string, bool> loaded_objects;
+
+                for (bool match_shared : { false, true }) {
+                    for (const auto& database : databases) {
+                        for (const auto& object : collection_futures[database + "." + object_type + "s"].get()) {
+                            if (!object.is_string("name")) {
+                                continue;
+                            }
+
+                            bool is_shared = !object.exists("app_id") || object["app_id"].is_null();
+                            bool is_own = object.is_string("app_id") && object["app_id"].get_string() == app_id;
+
+                            if ((match_shared && !is_shared) || (!match_shared && !is_own)) {
+                                continue;
+                            }
+
+                            const std::string cache_key = "vortex.core." + object_type + ".value." + app_id + "." + object["name"].get_string();
+
+                            if (!loaded_objects[cache_key]) {
+                                std::vector<std::string> tags = Cache::collection_tags(databases, object_type + "s");
+                                tags.push_back(Cache::application_tag(app_id));
+
+                                cache.set_element(cache_key, object, cache.object_expiry(), tags);
+                                loaded_objects[cache_key] = true;
+                                ++loaded_entries;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        pool.join();
+
+        return CacheWarmupResult{
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin_time).count(),
+            loaded_entries
+        };
+    }
+
+    bool CacheWarmup::is_enabled(const Maze::Element& config) {
+        return config.is_object("warmup") &&
+            config["warmup"].is_bool("enabled") &&
+            config["warmup"]["enabled"].get_bool();
+    }
+
+    std::vector<std::string> CacheWarmup::application_databases(const Maze::Element& application, const Maze::Element& host) const {
+        // Same lookup order as Application::find_object_in_application_storage
+        std::vector<std::string> databases;
+
+        Maze::Element application_config(Maze::Type::Object);
+        if (_config.is_object("application")) {
+            application_config.apply(_config["application"]);
+        }
+        if (application.is_object("config") && application["config"].is_object("application")) {
+            application_config.apply(application["config"]["application"]);
+        }
+        if (host.is_object("config") && host["config"].is_object("application")) {
+            application_config.apply(host["config"]["application"]);
+        }
+
+        if (application_config.is_string("database")) {
+            databases.push_back(application_config["database"].get_string());
+        }
+
+        const std::string app_id = get_object_id(application);
+        if (!app_id.empty() && (databases.empty() || databases[0] != app_id)) {
+            databases.push_back(app_id);
+        }
+
+        if (std::find(databases.begin(), databases.end(), "vortex") == databases.end()) {
+            databases.push_back("vortex");
+        }
+
+        return databases;
+    }
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Caching {
+
+    struct CacheWarmupResult {
+        long long duration_millis;
+        int loaded_entries;
+    };
+
+
+    class CacheWarmup {
+    public:
+        VORTEX_CORE_API CacheWarmup(const Maze::Element& config);
+
+        VORTEX_CORE_API const CacheWarmupResult run();
+
+        VORTEX_CORE_API static bool is_enabled(const Maze::Element& config);
+
+    private:
+        Maze::Element _config;
+        int _thread_count = 4;
+
+        // Server, application and host config are merged in the same order as the runtime does
+        std::vector<std::string> application_databases(const Maze::Element& application, const Maze::Element& host) const;
+    };
+
+}  // namespace Vortex::Core::Caching
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <boost/beast/http.hpp>
 #include <Maze/Maze.hpp>
 #include <Core/DLLSupport.h>
@@ -49,9 +50,12 @@ namespace Vortex::Core {
         VORTEX_CORE_API virtual std::string post_script() = 0;
         VORTEX_CORE_API inline virtual Maze::Element& application_ref() { return _application; }
 
+        VORTEX_CORE_API virtual std::vector<std::string> storage_databases(bool search_other_storages = true) = 0;
+        // Only the fields selected by the projection are returned, see StorageBackendInterface
         VORTEX_CORE_API virtual Maze::Element find_object_in_application_storage(
             const std::string& collection, const Maze::Element& query,
-            bool search_other_storages = true) = 0;
+            bool search_other_storages = true,
+            const Maze::Element& projection = Maze::Element(Maze::Type::Object)) = 0;
 
     protected:
         RuntimeInterface* _runtime;
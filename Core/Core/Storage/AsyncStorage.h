@@ -0,0 +1,171 @@
+#pragma once
+
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <Maze/Maze.hpp>
+#include <Core/Storage/Storage.h>
+
+namespace Vortex::Core::Storage {
+
+    // Asynchronous variants of the StorageBackendInterface methods. The blocking call runs on the blocking pool
+    // of the backend and completes with (std::exception_ptr, result) on the executor of the completion handler,
+    // so callbacks, boost::asio::use_future and boost::asio::use_awaitable can all be used as completion tokens.
+    //
+    // The request runtime is synchronous from init to run, so its own callers (application storage fallbacks)
+    // still wait for the futures. Only the concurrency between independent lookups is gained there, the thread
+    // serving the request stays blocked until the runtime finishes.
+
+    namespace Detail {
+
+        template <typename Result>
+        struct AsyncSignature {
+            typedef void type(std::exception_ptr, Result);
+        };
+
+        template <>
+        struct AsyncSignature<void> {
+            typedef void type(std::exception_ptr);
+        };
+
+        template <typename Result, typename Function, typename CompletionToken>
+        auto async_call(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+            Function function, CompletionToken&& token) {
+            // Routed collections may be served by a backend with a pool of its own
+            boost::asio::thread_pool& pool = backend->blocking_pool_for(database, collection);
+
+            auto initiation = [&pool](auto handler, Function function) {
+                // Handlers without an executor of their own complete on the blocking pool
+                auto work = boost::asio::make_work_guard(
+                    boost::asio::get_associated_executor(handler, pool.get_executor()));
+
+                boost::asio::post(pool,
+                    [handler = std::move(handler), function = std::move(function), work = std::move(work)]() mutable {
+                    std::exception_ptr error;
+                    auto executor = work.get_executor();
+
+                    if constexpr (std::is_void_v<Result>) {
+                        try {
+                            function();
+                        }
+                        catch (...) {
+                            error = std::current_exception();
+                        }
+
+                        boost::asio::dispatch(executor, [handler = std::move(handler), error]() mutable {
+                            handler(error);
+                            });
+                    }
+                    else {
+                        Result result{};
+
+                        try {
+                            result = function();
+                        }
+                        catch (...) {
+                            error = std::current_exception();
+                        }
+
+                        boost::asio::dispatch(executor, [handler = std::move(handler), error, result = std::move(result)]() mutable {
+                            handler(error, std::move(result));
+                            });
+                    }
+
+                    work.reset();
+                    });
+            };
+
+            return boost::asio::async_initiate<CompletionToken, typename AsyncSignature<Result>::type>(
+                initiation, token, std::move(function));
+        }
+
+    }  // namespace Detail
+
+
+    template <typename CompletionToken>
+    auto async_insert(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& value, CompletionToken&& token) {
+        return Detail::async_call<void>(backend, database, collection, [backend, database, collection, value]() {
+            backend->insert_document(database, collection, value);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_find_all(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, CompletionToken&& token) {
+        return Detail::async_call<Maze::Element>(backend, database, collection, [backend, database, collection, simple_query]() {
+            return backend->find_all_documents(database, collection, simple_query);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_find_all(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, const Maze::Element& projection, CompletionToken&& token) {
+        return Detail::async_call<Maze::Element>(backend, database, collection, [backend, database, collection, simple_query, projection]() {
+            return backend->find_all_documents(database, collection, simple_query, projection);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_find_first(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, CompletionToken&& token) {
+        return Detail::async_call<Maze::Element>(backend, database, collection, [backend, database, collection, simple_query]() {
+            return backend->find_first_document(database, collection, simple_query);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_find_first(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, const Maze::Element& projection, CompletionToken&& token) {
+        return Detail::async_call<Maze::Element>(backend, database, collection, [backend, database, collection, simple_query, projection]() {
+            return backend->find_first_document(database, collection, simple_query, projection);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_find_page(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, const QueryOptions& options, CompletionToken&& token) {
+        return Detail::async_call<Maze::Element>(backend, database, collection, [backend, database, collection, simple_query, options]() {
+            return backend->find_page(database, collection, simple_query, options);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_replace_first(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, const Maze::Element& replacement_value, CompletionToken&& token) {
+        return Detail::async_call<void>(backend, database, collection, [backend, database, collection, simple_query, replacement_value]() {
+            backend->replace_first_document(database, collection, simple_query, replacement_value);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_delete_all(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, CompletionToken&& token) {
+        return Detail::async_call<void>(backend, database, collection, [backend, database, collection, simple_query]() {
+            backend->delete_all_documents(database, collection, simple_query);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_delete_first(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        const Maze::Element& simple_query, CompletionToken&& token) {
+        return Detail::async_call<void>(backend, database, collection, [backend, database, collection, simple_query]() {
+            backend->delete_first_document(database, collection, simple_query);
+            }, std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto async_collection_exists(StorageBackendInterface* backend, const std::string& database, const std::string& collection,
+        CompletionToken&& token) {
+        return Detail::async_call<bool>(backend, database, collection, [backend, database, collection]() {
+            return backend->collection_exists(database, collection);
+            }, std::forward<CompletionToken>(token));
+    }
+
+}  // namespace Vortex::Core::Storage
@@ -0,0 +1,352 @@
+#include <Core/Storage/CachingStorageBackend.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <Core/GlobalRuntime.h>
+
+using Vortex::Core::Caching::Cache;
+
+namespace Vortex::Core::Storage {
+
+    namespace {
+
+        // Stable across processes so shared cache backends (Redis, Memcached) get the same keys everywhere.
+        // Collisions are possible, entries are verified against the stored query.
+        std::string fnv1a_hex(const std::string& value) {
+            uint64_t hash = 14695981039346656037ULL;
+
+            for (unsigned char c : value) {
+                hash ^= c;
+                hash *= 1099511628211ULL;
+            }
+
+            char buffer[17];
+            snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)hash);
+
+            return buffer;
+        }
+
+        bool parse_json(const std::string& json, Maze::Element& value) {
+            try {
+                value = Maze::Element::from_json(json);
+                return true;
+            }
+            catch (...) {
+                return false;
+            }
+        }
+
+        CachingSettings read_settings(const Maze::Element& config, const CachingSettings& defaults) {
+            CachingSettings settings = defaults;
+
+            if (config.is_bool("enabled")) {
+                settings.enabled = config["enabled"].get_bool();
+            }
+
+            if (config.is_int("expiry") && config["expiry"].get_int() >= 0) {
+                settings.expiry = config["expiry"].get_int();
+            }
+
+            return settings;
+        }
+
+    }  // namespace
+
+    CachingStorageBackend::CachingStorageBackend(StorageBackendInterface* backend, const Maze::Element& caching_config, ChangeFeed& change_feed)
+        : _backend(backend), _change_feed(change_feed) {
+        _default_settings = read_settings(caching_config, _default_settings);
+
+        const Maze::Element& collections = caching_config.get_const_ref("collections", Maze::Type::Object);
+        for (auto it = collections.keys_begin(); it != collections.keys_end(); ++it) {
+            if (collections.is_object(*it)) {
+                _collection_settings[*it] = read_settings(collections[*it], _default_settings);
+            }
+        }
+
+        // Pending reads are discarded by the generation. Entries are invalidated again after it was bumped, because the
+        // cache's own subscriber may have run first and a read could have stored its result in between.
+        _subscription_id = _change_feed.subscribe([this](const std::string& database, const std::string& collection, ChangeType change) {
+            {
+                std::lock_guard<std::mutex> lock(_generations_mtx);
+
+                if (collection.empty()) {
+                    for (auto& generation : _generations) {
+                        if (generation.first.compare(0, database.length() + 1, database + ".") == 0) {
+                            ++generation.second;
+                        }
+                    }
+                }
+                else {
+                    ++_generations[database + "." + collection];
+                }
+            }
+
+            const Cache& cache = GlobalRuntime::instance().cache();
+            if (cache.is_initialized()) {
+                cache.invalidate_tag(collection.empty() ? Cache::database_tag(database) : Cache::collection_tag(database, collection));
+            }
+            });
+    }
+
+    CachingStorageBackend::~CachingStorageBackend() {
+        _change_feed.unsubscribe(_subscription_id);
+    }
+
+    StorageBackendInterface* CachingStorageBackend::get_wrapped_backend() const {
+        return _backend;
+    }
+
+    void CachingStorageBackend::simple_insert(const std::string& database, const std::string& collection, const std::string& json_value) {
+        _backend->simple_insert(database, collection, json_value);
+        invalidate(database, collection);
+    }
+
+    const std::string CachingStorageBackend::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        Maze::Element simple_query;
+        if (!parse_json(json_simple_query, simple_query)) {
+            return _backend->simple_find_all(database, collection, json_simple_query);
+        }
+
+        return cached_json(database, collection, "simple_find_all", simple_query, [&]() {
+            return _backend->simple_find_all(database, collection, json_simple_query);
+            });
+    }
+
+    const std::string CachingStorageBackend::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        Maze::Element simple_query;
+        if (!parse_json(json_simple_query, simple_query)) {
+            return _backend->simple_find_first(database, collection, json_simple_query);
+        }
+
+        return cached_json(database, collection, "simple_find_first", simple_query, [&]() {
+            return _backend->simple_find_first(database, collection, json_simple_query);
+            });
+    }
+
+    void CachingStorageBackend::simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) {
+        _backend->simple_replace_first(database, collection, json_simple_query, replacement_json_value);
+        invalidate(database, collection);
+    }
+
+    void CachingStorageBackend::simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        _backend->simple_delete_all(database, collection, json_simple_query);
+        invalidate(database, collection);
+    }
+
+    void CachingStorageBackend::simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        _backend->simple_delete_first(database, collection, json_simple_query);
+        invalidate(database, collection);
+    }
+
+    void CachingStorageBackend::insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) {
+        _backend->insert_document(database, collection, value);
+        invalidate(database, collection);
+    }
+
+    Maze::Element CachingStorageBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return cached_element(database, collection, "find_all", simple_query, [&]() {
+            return _backend->find_all_documents(database, collection, simple_query);
+            });
+    }
+
+    Maze::Element CachingStorageBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return cached_element(database, collection, "find_first", simple_query, [&]() {
+            return _backend->find_first_document(database, collection, simple_query);
+            });
+    }
+
+    void CachingStorageBackend::replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) {
+        _backend->replace_first_document(database, collection, simple_query, replacement_value);
+        invalidate(database, collection);
+    }
+
+    void CachingStorageBackend::delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        _backend->delete_all_documents(database, collection, simple_query);
+        invalidate(database, collection);
+    }
+
+    void CachingStorageBackend::delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        _backend->delete_first_document(database, collection, simple_query);
+        invalidate(database, collection);
+    }
+
+    const std::string CachingStorageBackend::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) {
+        Maze::Element simple_query;
+        Maze::Element projection;
+        if (!parse_json(json_simple_query, simple_query) || !parse_json(json_projection, projection)) {
+            return _backend->simple_find_all(database, collection, json_simple_query, json_projection);
+        }
+
+        return cached_json(database, collection, "simple_find_all", Maze::Element({ "query", "projection" }, { simple_query, projection }), [&]() {
+            return _backend->simple_find_all(database, collection, json_simple_query, json_projection);
+            });
+    }
+
+    const std::string CachingStorageBackend::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) {
+        Maze::Element simple_query;
+        Maze::Element projection;
+        if (!parse_json(json_simple_query, simple_query) || !parse_json(json_projection, projection)) {
+            return _backend->simple_find_first(database, collection, json_simple_query, json_projection);
+        }
+
+        return cached_json(database, collection, "simple_find_first", Maze::Element({ "query", "projection" }, { simple_query, projection }), [&]() {
+            return _backend->simple_find_first(database, collection, json_simple_query, json_projection);
+            });
+    }
+
+    Maze::Element CachingStorageBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        return cached_element(database, collection, "find_all", Maze::Element({ "query", "projection" }, { simple_query, projection }), [&]() {
+            return _backend->find_all_documents(database, collection, simple_query, projection);
+            });
+    }
+
+    Maze::Element CachingStorageBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        return cached_element(database, collection, "find_first", Maze::Element({ "query", "projection" }, { simple_query, projection }), [&]() {
+            return _backend->find_first_document(database, collection, simple_query, projection);
+            });
+    }
+
+    std::unique_ptr<StorageCursor> CachingStorageBackend::find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) {
+        return _backend->find_documents(database, collection, simple_query, options);
+    }
+
+    const std::vector<std::string> CachingStorageBackend::get_database_list() {
+        return _backend->get_database_list();
+    }
+
+    const std::vector<std::string> CachingStorageBackend::get_collection_list(const std::string& database) {
+        return _backend->get_collection_list(database);
+    }
+
+    bool CachingStorageBackend::database_exists(const std::string& database) {
+        return _backend->database_exists(database);
+    }
+
+    bool CachingStorageBackend::collection_exists(const std::string& database, const std::string& collection) {
+        return _backend->collection_exists(database, collection);
+    }
+
+    boost::asio::thread_pool& CachingStorageBackend::blocking_pool() {
+        return _backend->blocking_pool();
+    }
+
+    boost::asio::thread_pool& CachingStorageBackend::blocking_pool_for(const std::string& database, const std::string& collection) {
+        return _backend->blocking_pool_for(database, collection);
+    }
+
+    Maze::Element CachingStorageBackend::normalize(const Maze::Element& value) {
+        if (value.is_array()) {
+            Maze::Element result(Maze::Type::Array);
+
+            for (int i = 0; i < value.count_children(); ++i) {
+                result << normalize(value[i]);
+            }
+
+            return result;
+        }
+
+        if (!value.is_object()) {
+            return value;
+        }
+
+        std::vector<std::string> keys(value.keys_begin(), value.keys_end());
+        std::sort(keys.begin(), keys.end());
+
+        Maze::Element result(Maze::Type::Object);
+        for (const auto& key : keys) {
+            result.set(key, normalize(value[key]));
+        }
+
+        return result;
+    }
+
+    CachingSettings CachingStorageBackend::get_settings(const std::string& database, const std::string& collection) const {
+        auto it = _collection_settings.find(database + "." + collection);
+
+        if (it == _collection_settings.end()) {
+            it = _collection_settings.find(collection);
+        }
+
+        return it != _collection_settings.end() ? it->second : _default_settings;
+    }
+
+    unsigned long long CachingStorageBackend::get_generation(const std::string& database, const std::string& collection) {
+        std::lock_guard<std::mutex> lock(_generations_mtx);
+
+        return _generations[database + "." + collection];
+    }
+
+    void CachingStorageBackend::invalidate(const std::string& database, const std::string& collection) {
+        {
+            std::lock_guard<std::mutex> lock(_generations_mtx);
+            ++_generations[database + "." + collection];
+        }
+
+        GlobalRuntime::instance().cache().invalidate_collection(database, collection);
+    }
+
+    Maze::Element CachingStorageBackend::cached_element(const std::string& database, const std::string& collection, const std::string& operation,
+        const Maze::Element& key_value, const std::function<Maze::Element()>& query) {
+        const CachingSettings settings = get_settings(database, collection);
+        const Cache& cache = GlobalRuntime::instance().cache();
+
+        if (!settings.enabled || !cache.is_initialized()) {
+            return query();
+        }
+
+        const std::string normalized_key = normalize(key_value).to_json(0);
+        const std::string cache_key = get_cache_key(database, collection, operation, normalized_key);
+        // A single read, the entry could expire between an exists check and the get
+        const Maze::Element cached_entry = cache.get_element(cache_key);
+        if (cached_entry.is_string("query") && cached_entry["query"].get_string() == normalized_key && cached_entry.exists("result")) {
+            return cached_entry["result"];
+        }
+
+        const unsigned long long generation = get_generation(database, collection);
+        Maze::Element result = query();
+
+        // Invalidations bump the generation under the same lock, so none can land between the check and the store
+        std::lock_guard<std::mutex> lock(_generations_mtx);
+        if (generation == _generations[database + "." + collection]) {
+            cache.set_element(cache_key, Maze::Element({ "query", "result" }, { Maze::Element(normalized_key), result }), settings.expiry,
+                { Cache::collection_tag(database, collection), Cache::database_tag(database) });
+        }
+
+        return result;
+    }
+
+    const std::string CachingStorageBackend::cached_json(const std::string& database, const std::string& collection, const std::string& operation,
+        const Maze::Element& key_value, const std::function<std::string()>& query) {
+        const CachingSettings settings = get_settings(database, collection);
+        const Cache& cache = GlobalRuntime::instance().cache();
+
+        if (!settings.enabled || !cache.is_initialized()) {
+            return query();
+        }
+
+        // Compact json never contains a raw newline, so it separates the query from the result
+        const std::string normalized_key = normalize(key_value).to_json(0);
+        const std::string cache_key = get_cache_key(database, collection, operation, normalized_key);
+        const std::string cached_entry = cache.get(cache_key);
+        if (cached_entry.length() > normalized_key.length() && cached_entry[normalized_key.length()] == '\n' &&
+            cached_entry.compare(0, normalized_key.length(), normalized_key) == 0) {
+            return cached_entry.substr(normalized_key.length() + 1);
+        }
+
+        const unsigned long long generation = get_generation(database, collection);
+        const std::string result = query();
+
+        std::lock_guard<std::mutex> lock(_generations_mtx);
+        if (generation == _generations[database + "." + collection]) {
+            cache.set(cache_key, normalized_key + "\n" + result, settings.expiry,
+                { Cache::collection_tag(database, collection), Cache::database_tag(database) });
+        }
+
+        return result;
+    }
+
+    const std::string CachingStorageBackend::get_cache_key(const std::string& database, const std::string& collection, const std::string& operation, const std::string& normalized_key) const {
+        return "vortex.core.storage.query." + database + "." + collection + "." + operation + "." + fnv1a_hex(normalized_key);
+    }
+
+}
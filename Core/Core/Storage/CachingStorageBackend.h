@@ -0,0 +1,92 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+#include <Core/Storage/Storage.h>
+
+namespace Vortex::Core::Storage {
+
+    struct CachingSettings {
+        bool enabled = true;
+        // Seconds, 0 keeps results until the collection changes
+        int expiry = 60;
+    };
+
+
+    // Caches find results of the wrapped backend keyed by database, collection and normalized query.
+    // Writes through the decorator and change feed events invalidate the results of the collection.
+    // Entries hold the normalized query next to the result, a hit is only used when the query matches,
+    // so colliding key hashes can't return the result of another query. Empty results are cached as well.
+    // The runtime keeps its own host, application, controller and view caches since this decorator is opt-in.
+    //
+    // Configured by storage.caching:
+    // { "enabled": true, "expiry": 60, "collections": { "database.collection" or "collection": { "enabled": ..., "expiry": ... } } }
+    class CachingStorageBackend : public StorageBackendInterface {
+    public:
+        VORTEX_CORE_API CachingStorageBackend(StorageBackendInterface* backend, const Maze::Element& caching_config, ChangeFeed& change_feed);
+        VORTEX_CORE_API ~CachingStorageBackend();
+
+        VORTEX_CORE_API StorageBackendInterface* get_wrapped_backend() const;
+
+        // Simple query
+        VORTEX_CORE_API virtual void simple_insert(const std::string& database, const std::string& collection, const std::string& json_value) override;
+        VORTEX_CORE_API virtual const std::string simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+        VORTEX_CORE_API virtual const std::string simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+        VORTEX_CORE_API virtual void simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) override;
+        VORTEX_CORE_API virtual void simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+        VORTEX_CORE_API virtual void simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+
+        // Structured query
+        VORTEX_CORE_API virtual void insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) override;
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual void replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) override;
+        VORTEX_CORE_API virtual void delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual void delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+
+        VORTEX_CORE_API virtual const std::string simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) override;
+        VORTEX_CORE_API virtual const std::string simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) override;
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+
+        // Cursors are not cached
+        VORTEX_CORE_API virtual std::unique_ptr<StorageCursor> find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) override;
+
+        VORTEX_CORE_API virtual const std::vector<std::string> get_database_list() override;
+        VORTEX_CORE_API virtual const std::vector<std::string> get_collection_list(const std::string& database) override;
+
+        VORTEX_CORE_API virtual bool database_exists(const std::string& database) override;
+        VORTEX_CORE_API virtual bool collection_exists(const std::string& database, const std::string& collection) override;
+
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool() override;
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool_for(const std::string& database, const std::string& collection) override;
+
+        // Object keys are sorted so equal queries written in a different order share their cache entry
+        VORTEX_CORE_API static Maze::Element normalize(const Maze::Element& value);
+
+    private:
+        StorageBackendInterface* _backend;
+        CachingSettings _default_settings;
+        std::map<std::string, CachingSettings> _collection_settings;
+        // Incremented by writes and change events, results read before a change finished are not stored
+        std::map<std::string, unsigned long long> _generations;
+        std::mutex _generations_mtx;
+        ChangeFeed& _change_feed;
+        int _subscription_id = 0;
+
+        CachingSettings get_settings(const std::string& database, const std::string& collection) const;
+        unsigned long long get_generation(const std::string& database, const std::string& collection);
+        void invalidate(const std::string& database, const std::string& collection);
+
+        Maze::Element cached_element(const std::string& database, const std::string& collection, const std::string& operation,
+            const Maze::Element& key_value, const std::function<Maze::Element()>& query);
+        const std::string cached_json(const std::string& database, const std::string& collection, const std::string& operation,
+            const Maze::Element& key_value, const std::function<std::string()>& query);
+        const std::string get_cache_key(const std::string& database, const std::string& collection, const std::string& operation, const std::string& normalized_key) const;
+    };
+
+}  // namespace Vortex::Core::Storage
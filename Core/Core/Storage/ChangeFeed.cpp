@@ -0,0 +1,38 @@
+#include <Core/Storage/ChangeFeed.h>
+#include <vector>
+
+namespace Vortex::Core::Storage {
+
+    int ChangeFeed::subscribe(const CollectionChangedHandler& handler) {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        int subscription_id = _next_subscription_id++;
+        _handlers[subscription_id] = handler;
+
+        return subscription_id;
+    }
+
+    void ChangeFeed::unsubscribe(int subscription_id) {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        _handlers.erase(subscription_id);
+    }
+
+    void ChangeFeed::publish(const std::string& database, const std::string& collection, ChangeType change) {
+        std::vector<CollectionChangedHandler> handlers;
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            for (const auto& handler : _handlers) {
+                handlers.push_back(handler.second);
+            }
+        }
+
+        // Handlers are called without holding the lock so they are free to (un)subscribe
+        for (const auto& handler : handlers) {
+            handler(database, collection, change);
+        }
+    }
+
+}
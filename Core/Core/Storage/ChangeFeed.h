@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Storage {
+
+    enum class ChangeType {
+        Modified,
+        // The collection (or the whole database) no longer exists
+        Dropped
+    };
+
+    typedef std::function<void(const std::string& database, const std::string& collection, ChangeType change)> CollectionChangedHandler;
+
+
+    class ChangeFeed {
+    public:
+        VORTEX_CORE_API int subscribe(const CollectionChangedHandler& handler);
+        VORTEX_CORE_API void unsubscribe(int subscription_id);
+
+        // Empty collection name means that the whole database has changed
+        VORTEX_CORE_API void publish(const std::string& database, const std::string& collection, ChangeType change = ChangeType::Modified);
+
+    private:
+        std::map<int, CollectionChangedHandler> _handlers;
+        int _next_subscription_id = 1;
+        std::mutex _mtx;
+    };
+
+}  // namespace Vortex::Core::Storage
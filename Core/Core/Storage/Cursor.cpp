@@ -0,0 +1,65 @@
+#include <Core/Storage/Cursor.h>
+#include <algorithm>
+
+namespace Vortex::Core::Storage {
+
+    const Maze::Element& StorageCursor::last_keyset() const {
+        return _last_keyset;
+    }
+
+    DocumentCursor::DocumentCursor(std::shared_ptr<const Maze::Element> documents, std::vector<int> positions, const QueryOptions& options)
+        : DocumentCursor(documents, [values = documents.get()](int position) -> const Maze::Element& { return (*values)[position]; },
+            std::move(positions), options) {}
+
+    DocumentCursor::DocumentCursor(std::shared_ptr<const void> owner, std::function<const Maze::Element&(int)> document,
+        std::vector<int> positions, const QueryOptions& options)
+        : _owner(owner), _document(document), _options(options) {
+        const auto& values = _document;
+        const std::vector<std::pair<std::string, int>> fields = _options.keyset_fields();
+
+        // Only positions are sorted and sliced, documents are copied when their batch is requested
+        if (_options.after.has_children()) {
+            for (int position : positions) {
+                if (QueryOptions::compare(values(position), _options.after, fields) > 0) {
+                    _positions.push_back(position);
+                }
+            }
+        }
+        else {
+            _positions = std::move(positions);
+        }
+
+        if (!fields.empty()) {
+            std::stable_sort(_positions.begin(), _positions.end(), [&values, &fields](int a, int b) {
+                return QueryOptions::compare(values(a), values(b), fields) < 0;
+                });
+        }
+
+        if (_options.skip > 0) {
+            _positions.erase(_positions.begin(), _positions.begin() + std::min((size_t)_options.skip, _positions.size()));
+        }
+
+        if (_options.limit > 0 && _positions.size() > (size_t)_options.limit) {
+            _positions.resize(_options.limit);
+        }
+    }
+
+    Maze::Element DocumentCursor::next_batch() {
+        Maze::Element batch(Maze::Type::Array);
+        const size_t end = std::min(_next + (size_t)std::max(_options.batch_size, 1), _positions.size());
+
+        for (; _next < end; ++_next) {
+            const Maze::Element& document = _document(_positions[_next]);
+
+            batch.push_back(_options.project(document));
+            _last_keyset = _options.keyset(document);
+        }
+
+        return batch;
+    }
+
+    const bool DocumentCursor::has_more() {
+        return _next < _positions.size();
+    }
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+#include <Core/Storage/QueryOptions.h>
+
+namespace Vortex::Core::Storage {
+
+    class StorageCursor {
+    public:
+        VORTEX_CORE_API virtual ~StorageCursor() {}
+
+        // Array of at most batch_size documents, empty once the cursor is exhausted
+        VORTEX_CORE_API virtual Maze::Element next_batch() = 0;
+        VORTEX_CORE_API virtual const bool has_more() = 0;
+
+        // Keyset of the last returned document (before projection), used to continue with QueryOptions::next_page
+        VORTEX_CORE_API const Maze::Element& last_keyset() const;
+
+    protected:
+        Maze::Element _last_keyset = Maze::Element(Maze::Type::Object);
+    };
+
+
+    // Cursor over documents which are already in memory, the query options are applied by the cursor
+    class DocumentCursor : public StorageCursor {
+    public:
+        // Positions are the matching documents in collection order
+        VORTEX_CORE_API DocumentCursor(std::shared_ptr<const Maze::Element> documents, std::vector<int> positions, const QueryOptions& options);
+        // Documents are resolved through the accessor, the owner keeps them alive for the lifetime of the cursor
+        VORTEX_CORE_API DocumentCursor(std::shared_ptr<const void> owner, std::function<const Maze::Element&(int)> document,
+            std::vector<int> positions, const QueryOptions& options);
+
+        VORTEX_CORE_API virtual Maze::Element next_batch() override;
+        VORTEX_CORE_API virtual const bool has_more() override;
+
+    private:
+        std::shared_ptr<const void> _owner;
+        std::function<const Maze::Element&(int)> _document;
+        std::vector<int> _positions;
+        size_t _next = 0;
+        QueryOptions _options;
+    };
+
+}  // namespace Vortex::Core::Storage
@@ -4,15 +4,24 @@
 #include <Core/Exceptions/StorageException.h>
 #include <Core/GlobalRuntime.h>
 #include <Core/Util/String.h>
+#include <Core/Util/Time.h>
 #include <boost/filesystem.hpp>
 #include <boost/range/iterator_range.hpp>
 #define BOOST_ERROR_CODE_HEADER_ONLY
 
 namespace Vortex::Core::Storage::Filesystem {
 
-    FilesystemBackend::FilesystemBackend() {}
+    FilesystemBackend::FilesystemBackend() : _write_log(_sync) {}
 
-    FilesystemBackend::~FilesystemBackend() {}
+    FilesystemBackend::~FilesystemBackend() {
+        // Pending async operations finish before the write log goes away
+        if (_io_pool) {
+            _io_pool->join();
+        }
+
+        _write_log.stop();
+        _sync.stop();
+    }
 
     void FilesystemBackend::set_config(const Maze::Element& filesystem_config) {
         _filesystem_config = filesystem_config;
@@ -33,11 +42,51 @@ namespace Vortex::Core::Storage::Filesystem {
                 _cache_expiry = 0;
             }
         }
+
+        if (_filesystem_config.is_string("format")) {
+            _format = (_filesystem_config["format"].get_string() == "jsonl") ?
+                FilesystemCollectionFormat::JsonLines : FilesystemCollectionFormat::Json;
+        }
+
+        if (_filesystem_config.is_bool("memory_mapping")) {
+            _memory_mapping = _filesystem_config["memory_mapping"].get_bool();
+        }
+
+        if (_filesystem_config.is_bool("resident_collections")) {
+            _resident_collections = _filesystem_config["resident_collections"].get_bool();
+        }
+
+        if (_filesystem_config.is_int("io_threads") && _filesystem_config["io_threads"].get_int() > 0) {
+            _io_threads = _filesystem_config["io_threads"].get_int();
+        }
+
+        if (_filesystem_config.is_string("root_path") && !_in_memory_only) {
+            _sync.set_config(_filesystem_config.get_const_ref("durability", Maze::Type::Object));
+            _write_log.set_config(_filesystem_config["root_path"].get_string(),
+                _filesystem_config.get_const_ref("write_log", Maze::Type::Object));
+
+            if (_write_log.is_enabled()) {
+                _write_log.start([this](const std::string& database, const std::string& collection) {
+                    write_collection_file(database, collection, load_collection_file(database, collection));
+                    });
+            }
+        }
+
+        // In memory only collections are never written to disk so there is nothing to watch
+        if (_filesystem_config.is_bool("watch_changes") && _filesystem_config["watch_changes"].get_bool() &&
+            _filesystem_config.is_string("root_path") && !_in_memory_only) {
+            _watcher.start(_filesystem_config["root_path"].get_string(), [this](const std::string& database, const std::string& collection, ChangeType change) {
+                // Replacing a file through rename is reported like any other write
+                if (!collection.empty() && is_own_write(database, collection)) {
+                    return;
+                }
+
+                on_collection_changed(database, collection, true);
+                });
+        }
     }
 
     void FilesystemBackend::simple_insert(const std::string& database, const std::string& collection, const std::string& json_value) {
-        Maze::Element collection_data = get_collection_entries(database, collection);
-
         Maze::Element value;
         try {
             value = Maze::Element::from_json(json_value);
@@ -46,131 +95,193 @@ namespace Vortex::Core::Storage::Filesystem {
             throw Exceptions::StorageException("Unable to parse json value");
         }
 
-        collection_data.push_back(value);
-
-        save_collection_entries(database, collection, collection_data);
+        insert_document(database, collection, value);
     }
 
     const std::string FilesystemBackend::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
-        Maze::Element collection_data = get_collection_entries(database, collection);
+        return find_all_documents(database, collection, parse_query(json_simple_query)).to_json();
+    }
 
-        Maze::Element simple_query;
+    const std::string FilesystemBackend::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        return find_first_document(database, collection, parse_query(json_simple_query)).to_json();
+    }
+
+    void FilesystemBackend::simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) {
+        Maze::Element simple_query = parse_query(json_simple_query);
+
+        Maze::Element replacement_value;
         try {
-            simple_query = Maze::Element::from_json(json_simple_query);
+            replacement_value = Maze::Element::from_json(replacement_json_value);
         }
         catch (...) {
-            throw Exceptions::StorageException("Invalid query syntax");
+            throw Exceptions::StorageException("Unable to parse replacement json value");
         }
 
+        replace_first_document(database, collection, simple_query, replacement_value);
+    }
+
+    void FilesystemBackend::simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        delete_all_documents(database, collection, parse_query(json_simple_query));
+    }
+
+    void FilesystemBackend::simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        delete_first_document(database, collection, parse_query(json_simple_query));
+    }
+
+    void FilesystemBackend::insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) {
+        std::lock_guard<std::mutex> writer_lock(get_writer_mutex(database, collection));
+
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection, true);
+
+        save_collection_entries(database, collection, collection_data->inserted(value), FilesystemWriteLog::insert_operation(value));
+    }
+
+    Maze::Element FilesystemBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return find_all_documents(database, collection, simple_query, Maze::Element(Maze::Type::Object));
+    }
+
+    Maze::Element FilesystemBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
         Maze::Element query_results(Maze::Type::Array);
+        QueryOptions options;
+        options.projection = projection;
 
-        for (const auto& val : collection_data) {
-            if (check_if_matches_simple_query(val, simple_query)) {
-                query_results.push_back(val);
+        auto collect_results = [this, &simple_query, &options, &query_results](int position, const Maze::Element& value) {
+            if (check_if_matches_simple_query(value, simple_query)) {
+                query_results.push_back(options.project(value));
             }
+
+            return true;
+        };
+
+        // Only the matching documents are kept in memory
+        if (can_stream(database, collection)) {
+            scan_collection_file(database, collection, collect_results);
+
+            return query_results;
         }
 
-        return query_results.to_json();
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection);
+
+        find_matching(*collection_data, simple_query, [&options, &query_results](int position, const Maze::Element& value) {
+            query_results.push_back(options.project(value));
+
+            return true;
+            });
+
+        return query_results;
     }
 
-    const std::string FilesystemBackend::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
-        Maze::Element collection_data = get_collection_entries(database, collection);
+    Maze::Element FilesystemBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return find_first_document(database, collection, simple_query, Maze::Element(Maze::Type::Object));
+    }
 
-        Maze::Element simple_query;
-        try {
-            simple_query = Maze::Element::from_json(json_simple_query);
-        }
-        catch (...) {
-            throw Exceptions::StorageException("Invalid query syntax");
-        }
+    Maze::Element FilesystemBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        Maze::Element result(Maze::Type::Object);
+        QueryOptions options;
+        options.projection = projection;
 
-        for (const auto& val : collection_data) {
-            if (check_if_matches_simple_query(val, simple_query)) {
-                return val.to_json();
-            }
+        // Scanning stops at the first match, the rest of the file is never parsed
+        if (can_stream(database, collection)) {
+            scan_collection_file(database, collection, [this, &simple_query, &options, &result](int position, const Maze::Element& value) {
+                if (!check_if_matches_simple_query(value, simple_query)) {
+                    return true;
+                }
+
+                result = options.project(value);
+
+                return false;
+                });
+
+            return result;
         }
 
-        return "{}";
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection);
+
+        find_matching(*collection_data, simple_query, [&options, &result](int position, const Maze::Element& value) {
+            result = options.project(value);
+
+            return false;
+            });
+
+        return result;
     }
 
-    void FilesystemBackend::simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) {
-        Maze::Element collection_data = get_collection_entries(database, collection);
-        Maze::Element new_collection_data(Maze::Type::Object);
+    void FilesystemBackend::replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) {
+        std::lock_guard<std::mutex> writer_lock(get_writer_mutex(database, collection));
 
-        Maze::Element simple_query;
-        try {
-            simple_query = Maze::Element::from_json(json_simple_query);
-        }
-        catch (...) {
-            throw Exceptions::StorageException("Invalid query syntax");
-        }
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection, true);
 
-        Maze::Element replacement_value;
-        try {
-            replacement_value = Maze::Element::from_json(replacement_json_value);
-        }
-        catch (...) {
-            throw Exceptions::StorageException("Unable to parse replacement json value");
-        }
+        int replaced_position = -1;
+        find_matching(*collection_data, simple_query, [&replaced_position](int position, const Maze::Element& value) {
+            replaced_position = position;
 
-        bool is_replaced = false;
-        for (const auto& val : collection_data) {
-            if (!is_replaced && check_if_matches_simple_query(val, simple_query)) {
-                new_collection_data.push_back(replacement_value);
-                is_replaced = true;
-            }
-            else {
-                new_collection_data.push_back(val);
-            }
+            return false;
+            });
+
+        if (replaced_position < 0) {
+            return;
         }
 
-        save_collection_entries(database, collection, new_collection_data);
+        save_collection_entries(database, collection, collection_data->replaced(replaced_position, replacement_value),
+            FilesystemWriteLog::replace_operation(replaced_position, replacement_value));
     }
 
-    void FilesystemBackend::simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
-        Maze::Element collection_data = get_collection_entries(database, collection);
+    void FilesystemBackend::delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        std::lock_guard<std::mutex> writer_lock(get_writer_mutex(database, collection));
 
-        Maze::Element simple_query;
-        try {
-            simple_query = Maze::Element::from_json(json_simple_query);
-        }
-        catch (...) {
-            throw Exceptions::StorageException("Invalid query syntax");
-        }
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection, true);
 
-        for (int i = 0; i < collection_data.count_children(); ++i) {
-            Maze::Element value = collection_data[i];
+        std::vector<int> positions;
+        find_matching(*collection_data, simple_query, [&positions](int position, const Maze::Element& value) {
+            positions.push_back(position);
 
-            if (check_if_matches_simple_query(value, simple_query)) {
-                collection_data.remove_at(i);
-            }
+            return true;
+            });
+
+        if (positions.empty()) {
+            return;
         }
 
-        save_collection_entries(database, collection, collection_data);
+        save_collection_entries(database, collection, collection_data->removed(positions), FilesystemWriteLog::delete_operation(positions));
     }
 
-    void FilesystemBackend::simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
-        Maze::Element collection_data = get_collection_entries(database, collection);
+    void FilesystemBackend::delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        std::lock_guard<std::mutex> writer_lock(get_writer_mutex(database, collection));
 
-        Maze::Element simple_query;
-        try {
-            simple_query = Maze::Element::from_json(json_simple_query);
-        }
-        catch (...) {
-            throw Exceptions::StorageException("Invalid query syntax");
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection, true);
+
+        int deleted_position = -1;
+        find_matching(*collection_data, simple_query, [&deleted_position](int position, const Maze::Element& value) {
+            deleted_position = position;
+
+            return false;
+            });
+
+        if (deleted_position < 0) {
+            return;
         }
 
-        for (int i = 0; i < collection_data.count_children(); ++i) {
-            Maze::Element value = collection_data[i];
+        save_collection_entries(database, collection, collection_data->removed({ deleted_position }),
+            FilesystemWriteLog::delete_operation({ deleted_position }));
+    }
 
-            if (check_if_matches_simple_query(value, simple_query)) {
-                collection_data.remove_at(i);
+    std::unique_ptr<StorageCursor> FilesystemBackend::find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) {
+        std::shared_ptr<const FilesystemCollection> collection_data = get_collection(database, collection);
 
-                save_collection_entries(database, collection, collection_data);
+        // Without ordering, matching can stop once enough documents were found
+        const size_t needed = (options.limit > 0 && options.keyset_fields().empty()) ? (size_t)options.skip + options.limit : 0;
 
-                return;
-            }
-        }
+        std::vector<int> positions;
+        find_matching(*collection_data, simple_query, [&positions, needed](int position, const Maze::Element& value) {
+            positions.push_back(position);
+
+            return needed == 0 || positions.size() < needed;
+            });
+
+        // The cursor keeps the snapshot alive, later writes don't affect it
+        return std::make_unique<DocumentCursor>(collection_data,
+            [collection = collection_data.get()](int position) -> const Maze::Element& { return collection->document(position); },
+            positions, options);
     }
 
     const std::vector<std::string> FilesystemBackend::get_database_list() {
@@ -233,9 +344,10 @@ namespace Vortex::Core::Storage::Filesystem {
                 std::string file_name = dir_entry.path().filename().string();
 
                 if (Util::String::ends_with(file_name, ".json")) {
-                    std::string name = file_name.substr(0, file_name.length() - 5);
-
-                    collection_list.push_back(name);
+                    collection_list.push_back(file_name.substr(0, file_name.length() - 5));
+                }
+                else if (Util::String::ends_with(file_name, ".jsonl")) {
+                    collection_list.push_back(file_name.substr(0, file_name.length() - 6));
                 }
             }
         }
@@ -281,9 +393,10 @@ namespace Vortex::Core::Storage::Filesystem {
             }
         }
 
-        std::string collection_path = _filesystem_config["root_path"].get_string() + "/" + database + "/" + collection + ".json";
+        std::string collection_path = _filesystem_config["root_path"].get_string() + "/" + database + "/" + collection;
 
-        if (boost::filesystem::exists(collection_path) && boost::filesystem::is_regular_file(collection_path)) {
+        if ((boost::filesystem::exists(collection_path + ".json") && boost::filesystem::is_regular_file(collection_path + ".json")) ||
+            (boost::filesystem::exists(collection_path + ".jsonl") && boost::filesystem::is_regular_file(collection_path + ".jsonl"))) {
             if (_cache_enabled) {
                 GlobalRuntime::instance().cache().set(cache_key, "1", 15);
             }
@@ -299,6 +412,118 @@ namespace Vortex::Core::Storage::Filesystem {
         }
     }
 
+    boost::asio::thread_pool& FilesystemBackend::blocking_pool() {
+        std::lock_guard<std::mutex> lock(_io_pool_mtx);
+
+        if (!_io_pool) {
+            _io_pool = std::make_unique<boost::asio::thread_pool>(_io_threads);
+        }
+
+        return *_io_pool;
+    }
+
+    void FilesystemBackend::convert_collection(const std::string& database, const std::string& collection, FilesystemCollectionFormat format) {
+        if (_in_memory_only) {
+            throw Exceptions::StorageException("In memory only collections are not stored in files");
+        }
+
+        std::lock_guard<std::mutex> writer_lock(get_writer_mutex(database, collection));
+
+        const FilesystemCollectionFormat current_format = get_collection_format(database, collection);
+
+        if (!boost::filesystem::exists(get_collection_file_path(database, collection, current_format))) {
+            throw Exceptions::StorageException("Collection " + database + "/" + collection + " does not exist");
+        }
+
+        Maze::Element values = load_collection_file(database, collection);
+
+        if (current_format != format) {
+            const std::string contents = (format == FilesystemCollectionFormat::JsonLines) ?
+                FilesystemJsonLines::serialize(values) : values.to_json(4);
+
+            _write_log.checkpoint(database, collection, contents);
+            write_own_file(database, collection, get_collection_file_path(database, collection, format), contents);
+
+            boost::system::error_code ec;
+            boost::filesystem::remove(get_collection_file_path(database, collection, current_format), ec);
+        }
+
+        // Everything logged is contained in the converted file
+        _write_log.clear(database, collection);
+
+        on_collection_changed(database, collection, true);
+    }
+
+    void FilesystemBackend::on_collection_changed(const std::string& database, const std::string& collection, bool external_change) const {
+        // Bumped before the contents cache is dropped, so a reader can't store what it read before the change afterwards
+        {
+            std::lock_guard<std::mutex> lock(_generations_mtx);
+
+            if (collection.empty()) {
+                const std::string prefix = database + ".";
+
+                for (auto& generation : _generations) {
+                    if (Util::String::starts_with(generation.first, prefix)) {
+                        ++generation.second;
+                    }
+                }
+            }
+            else {
+                ++_generations[database + "." + collection];
+            }
+        }
+
+        if (_cache_enabled) {
+            Caching::Cache& cache = GlobalRuntime::instance().cache();
+
+            cache.remove("vortex.core.filesystem.database_list");
+            cache.remove("vortex.core.filesystem.database_exists." + database);
+            cache.remove("vortex.core.filesystem.collection_list." + database);
+
+            if (!collection.empty()) {
+                cache.remove("vortex.core.filesystem.collection_exists." + database + "." + collection);
+
+                // In memory only collections were just stored in the contents cache. Other writes dropped it
+                // before writing, but a reader may have filled it again in the meantime.
+                if (external_change || !_in_memory_only) {
+                    cache.remove("vortex.core.filesystem.cache." + database + "." + collection);
+                }
+            }
+        }
+
+        if (external_change) {
+            {
+                std::lock_guard<std::mutex> lock(_mapped_mtx);
+
+                if (collection.empty()) {
+                    const std::string prefix = database + ".";
+
+                    for (auto it = _mapped.begin(); it != _mapped.end();) {
+                        it = Util::String::starts_with(it->first, prefix) ? _mapped.erase(it) : std::next(it);
+                    }
+                }
+                else {
+                    _mapped.erase(database + "." + collection);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(_resident_mtx);
+
+            if (collection.empty()) {
+                const std::string prefix = database + ".";
+
+                for (auto it = _resident.begin(); it != _resident.end();) {
+                    it = Util::String::starts_with(it->first, prefix) ? _resident.erase(it) : std::next(it);
+                }
+            }
+            else {
+                _resident.erase(database + "." + collection);
+            }
+        }
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
+    }
+
     bool FilesystemBackend::check_if_matches_simple_query(const Maze::Element& value, Maze::Element simple_query) const {
         bool value_valid = true;
 
@@ -384,80 +609,389 @@ namespace Vortex::Core::Storage::Filesystem {
 
         if (_cache_enabled) {
             if (GlobalRuntime::instance().cache().exists(cache_key)) {
-                return Maze::Element::from_json(GlobalRuntime::instance().cache().get(cache_key));
+                Maze::Element cached_entries = GlobalRuntime::instance().cache().get_element(cache_key);
+
+                if (cached_entries.is_array()) {
+                    return cached_entries;
+                }
             }
         }
 
+        unsigned long long generation;
+        {
+            std::lock_guard<std::mutex> lock(_generations_mtx);
+            generation = _generations[database + "." + collection];
+        }
+
+        Maze::Element result = load_collection_file(database, collection);
+
+        if (_cache_enabled) {
+            // Changes bump the generation under the same lock, so none can land between the check and the store
+            std::lock_guard<std::mutex> lock(_generations_mtx);
+
+            if (generation == _generations[database + "." + collection]) {
+                GlobalRuntime::instance().cache().set_element(cache_key, result, _cache_expiry);
+            }
+        }
+
+        return result;
+    }
+
+    void FilesystemBackend::save_collection_entries(const std::string& database, const std::string& collection, std::shared_ptr<const FilesystemCollection> collection_data,
+        const Maze::Element& operation) const {
+        const std::string cache_key = "vortex.core.filesystem.cache." + database + "." + collection;
+
+        set_resident_collection(database, collection, collection_data);
+
+        // Without a file the cache is the only copy of the contents, so it has to hold all of them
+        if (_in_memory_only) {
+            GlobalRuntime::instance().cache().set_element(cache_key, collection_data->documents(), 0);
+            on_collection_changed(database, collection, false);
+
+            return;
+        }
+
+        // Encoding the whole collection on every write is what resident collections avoid, readers which
+        // miss the resident version reload the file instead
+        if (_cache_enabled) {
+            GlobalRuntime::instance().cache().remove(cache_key);
+        }
+
+        if (_write_log.is_enabled() && operation.is_object()) {
+            _write_log.append(database, collection, operation);
+        }
+        else {
+            write_collection_file(database, collection, collection_data->documents());
+
+            // Values already contain everything that was logged before
+            _write_log.clear(database, collection);
+        }
+
+        on_collection_changed(database, collection, false);
+    }
+
+    Maze::Element FilesystemBackend::load_collection_file(const std::string& database, const std::string& collection) const {
         if (!_filesystem_config.is_string("root_path")) {
             throw Exceptions::StorageException("Invalid config root_path");
         }
 
-        std::string collection_file_path = _filesystem_config["root_path"].get_string() + '/' + database + '/' + collection + ".json";
-        if (!boost::filesystem::exists(collection_file_path)) {
-            return Maze::Element(Maze::Type::Array);
+        Maze::Element collection_data(Maze::Type::Array);
+
+        const FilesystemCollectionFormat format = get_collection_format(database, collection);
+        std::string collection_file_path = get_collection_file_path(database, collection, format);
+
+        if (boost::filesystem::exists(collection_file_path)) {
+            if (_memory_mapping) {
+                collection_data = get_mapped_collection(database, collection, format)->documents();
+            }
+            else if (format == FilesystemCollectionFormat::JsonLines) {
+                collection_data = FilesystemJsonLines::read(collection_file_path);
+            }
+            else {
+                std::ifstream collection_file(collection_file_path);
+                if (!collection_file.is_open()) {
+                    throw Exceptions::StorageException(
+                        "Unable to open collection file for " + database + "/" + collection);
+                }
+
+                std::stringstream value_stream;
+                value_stream << collection_file.rdbuf();
+                std::string value = value_stream.str();
+                collection_file.close();
+
+                try {
+                    collection_data = Maze::Element::from_json(value);
+                }
+                catch (...) {
+                    throw Exceptions::StorageException("Collection file is corrupted (unable to parse json)");
+                }
+            }
+        }
+
+        // Operations which were not compacted into the collection file yet
+        _write_log.replay(database, collection, collection_file_path, collection_data);
+
+        return collection_data;
+    }
+
+    void FilesystemBackend::write_collection_file(const std::string& database, const std::string& collection, const Maze::Element& values) const {
+        if (!_filesystem_config.is_string("root_path")) {
+            throw Exceptions::StorageException("Invalid config root_path");
         }
 
-        std::ifstream collection_file(collection_file_path);
-        if (!collection_file.is_open()) {
-            throw Exceptions::StorageException(
-                "Unable to open collection file for " + database + "/" + collection);
+        std::string database_folder_path = _filesystem_config["root_path"].get_string() + '/' + database;
+
+        if (!boost::filesystem::exists(database_folder_path)) {
+            boost::filesystem::create_directory(database_folder_path);
         }
 
-        std::stringstream value_stream;
-        value_stream << collection_file.rdbuf();
-        std::string value = value_stream.str();
-        collection_file.close();
+        const FilesystemCollectionFormat format = get_collection_format(database, collection);
+        const std::string contents = (format == FilesystemCollectionFormat::JsonLines) ?
+            FilesystemJsonLines::serialize(values) : values.to_json(4);
+
+        // The mapping keeps the old file open, which would prevent replacing it on some platforms
+        remove_mapped_collection(database, collection);
+
+        _write_log.checkpoint(database, collection, contents);
+
+        write_own_file(database, collection, get_collection_file_path(database, collection, format), contents);
+    }
+
+    void FilesystemBackend::write_own_file(const std::string& database, const std::string& collection, const std::string& path, const std::string& contents) const {
+        const std::string key = database + "." + collection;
 
-        Maze::Element collection_data;
+        {
+            std::lock_guard<std::mutex> lock(_own_writes_mtx);
+            _own_writes[key].pending++;
+        }
+
+        FileIdentity identity;
         try {
-            Maze::Element result = Maze::Element::from_json(value);
+            identity = _sync.write_file(path, contents);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(_own_writes_mtx);
+            _own_writes[key].pending--;
+            throw;
+        }
 
-            if (_cache_enabled) {
-                GlobalRuntime::instance().cache().set(cache_key, value, _cache_expiry);
+        std::lock_guard<std::mutex> lock(_own_writes_mtx);
+        OwnWrite& own_write = _own_writes[key];
+        own_write.pending--;
+        own_write.identity = identity;
+    }
+
+    bool FilesystemBackend::is_own_write(const std::string& database, const std::string& collection) const {
+        const std::string path = get_collection_file_path(database, collection, get_collection_format(database, collection));
+
+        std::lock_guard<std::mutex> lock(_own_writes_mtx);
+
+        auto it = _own_writes.find(database + "." + collection);
+        if (it == _own_writes.end()) {
+            return false;
+        }
+
+        return it->second.pending > 0 || (it->second.identity.exists && FileIdentity::of(path) == it->second.identity);
+    }
+
+    FilesystemCollectionFormat FilesystemBackend::get_collection_format(const std::string& database, const std::string& collection) const {
+        if (boost::filesystem::exists(get_collection_file_path(database, collection, FilesystemCollectionFormat::JsonLines))) {
+            return FilesystemCollectionFormat::JsonLines;
+        }
+
+        if (boost::filesystem::exists(get_collection_file_path(database, collection, FilesystemCollectionFormat::Json))) {
+            return FilesystemCollectionFormat::Json;
+        }
+
+        return _format;
+    }
+
+    const std::string FilesystemBackend::get_collection_file_path(const std::string& database, const std::string& collection, FilesystemCollectionFormat format) const {
+        return _filesystem_config["root_path"].get_string() + '/' + database + '/' + collection +
+            (format == FilesystemCollectionFormat::JsonLines ? ".jsonl" : ".json");
+    }
+
+    std::shared_ptr<const FilesystemMappedCollection> FilesystemBackend::get_mapped_collection(const std::string& database, const std::string& collection, FilesystemCollectionFormat format) const {
+        const std::string mapped_key = database + "." + collection;
+
+        {
+            std::lock_guard<std::mutex> lock(_mapped_mtx);
+
+            const auto& it = _mapped.find(mapped_key);
+            if (it != _mapped.end() && it->second->is_current()) {
+                return it->second;
             }
+        }
 
-            return result;
+        // Mapping and indexing happens outside the lock like loading of resident collections
+        std::shared_ptr<const FilesystemMappedCollection> mapped_collection = std::make_shared<FilesystemMappedCollection>(
+            get_collection_file_path(database, collection, format), format);
+
+        std::lock_guard<std::mutex> lock(_mapped_mtx);
+        _mapped[mapped_key] = mapped_collection;
+
+        return mapped_collection;
+    }
+
+    void FilesystemBackend::remove_mapped_collection(const std::string& database, const std::string& collection) const {
+        std::lock_guard<std::mutex> lock(_mapped_mtx);
+
+        _mapped.erase(database + "." + collection);
+    }
+
+    bool FilesystemBackend::can_stream(const std::string& database, const std::string& collection) const {
+        if (_resident_collections || _in_memory_only || !_filesystem_config.is_string("root_path")) {
+            return false;
         }
-        catch (...) {
-            throw Exceptions::StorageException("Collection file is corrupted (unable to parse json)");
+
+        // Json arrays can only be streamed through the document index of a mapped file
+        const FilesystemCollectionFormat format = get_collection_format(database, collection);
+        if ((format == FilesystemCollectionFormat::Json && !_memory_mapping) ||
+            !boost::filesystem::exists(get_collection_file_path(database, collection, format)) ||
+            _write_log.has_log(database, collection)) {
+            return false;
         }
 
-        return Maze::Element(Maze::Type::Array);
+        // Cached contents may be newer than the file and are already in memory anyway
+        return !(_cache_enabled && GlobalRuntime::instance().cache().exists("vortex.core.filesystem.cache." + database + "." + collection));
     }
 
-    void FilesystemBackend::save_collection_entries(const std::string& database, const std::string& collection, const Maze::Element& values) const {
-        const std::string cache_key = "vortex.core.filesystem.cache." + database + "." + collection;
+    void FilesystemBackend::scan_collection_file(const std::string& database, const std::string& collection,
+        const std::function<bool(int position, const Maze::Element& value)>& visitor) const {
+        const FilesystemCollectionFormat format = get_collection_format(database, collection);
 
-        if (_in_memory_only) {
-            GlobalRuntime::instance().cache().set(cache_key, values.to_json(0), 0);
+        if (_memory_mapping) {
+            get_mapped_collection(database, collection, format)->scan(visitor);
+        }
+        else {
+            FilesystemJsonLines::scan(get_collection_file_path(database, collection, format), visitor);
+        }
+    }
+
+    std::shared_ptr<const FilesystemCollection> FilesystemBackend::get_collection(const std::string& database, const std::string& collection, bool for_write) const {
+        const std::string resident_key = database + "." + collection;
+
+        if (_resident_collections) {
+            std::lock_guard<std::mutex> lock(_resident_mtx);
+
+            const auto& it = _resident.find(resident_key);
+            if (it != _resident.end()) {
+                if (_cache_expiry <= 0 || Util::Time::get_now_millis() - it->second.loaded_timestamp < _cache_expiry * (long long)1000) {
+                    return it->second.collection;
+                }
+
+                _resident.erase(it);
+            }
+        }
+
+        // A reader which missed the cache may have stored contents loaded before the last write
+        Maze::Element documents = (for_write && !_in_memory_only) ?
+            load_collection_file(database, collection) : get_collection_entries(database, collection);
+
+        // Loading and indexing happens outside the lock, concurrent loads of the same collection are harmless
+        std::shared_ptr<const FilesystemCollection> collection_data = std::make_shared<FilesystemCollection>(
+            documents, get_collection_indexes(database, collection));
 
+        if (!_resident_collections) {
+            return collection_data;
+        }
+
+        std::lock_guard<std::mutex> lock(_resident_mtx);
+
+        // Never replace a version stored by a writer while this one was loading
+        auto resident = _resident.emplace(resident_key, ResidentCollection{ collection_data, Util::Time::get_now_millis() });
+
+        return resident.first->second.collection;
+    }
+
+    std::mutex& FilesystemBackend::get_writer_mutex(const std::string& database, const std::string& collection) const {
+        std::lock_guard<std::mutex> lock(_writer_mutexes_mtx);
+
+        // Map nodes are stable, the returned mutex stays valid
+        return _writer_mutexes[database + "." + collection];
+    }
+
+    void FilesystemBackend::set_resident_collection(const std::string& database, const std::string& collection, std::shared_ptr<const FilesystemCollection> collection_data) const {
+        if (!_resident_collections) {
             return;
         }
 
-        if (_cache_enabled) {
-            GlobalRuntime::instance().cache().set(cache_key, values.to_json(0), _cache_expiry);
+        std::lock_guard<std::mutex> lock(_resident_mtx);
+
+        _resident[database + "." + collection] = ResidentCollection{ collection_data, Util::Time::get_now_millis() };
+    }
+
+    std::vector<FilesystemIndexFields> FilesystemBackend::get_collection_indexes(const std::string& database, const std::string& collection) const {
+        std::vector<FilesystemIndexFields> indexes;
+
+        if (!_resident_collections) {
+            return indexes;
         }
 
-        if (!_filesystem_config.is_string("root_path")) {
-            throw Exceptions::StorageException("Invalid config root_path");
+        // Indexes are configured per "database.collection" or per collection name in every database
+        const Maze::Element& configured_indexes = _filesystem_config.get_const_ref("indexes", Maze::Type::Object);
+        Maze::Element index_config;
+
+        if (configured_indexes.exists(database + "." + collection)) {
+            index_config = configured_indexes[database + "." + collection];
+        }
+        else if (configured_indexes.exists(collection)) {
+            index_config = configured_indexes[collection];
         }
+        else {
+            // Defaults cover the lookups made by the runtime
+            if (collection == "hosts") {
+                indexes.push_back({ "hostname" });
+            }
+            else if (collection == "apps") {
+                indexes.push_back({ "_id.$oid" });
+            }
+            else if (collection == "controllers") {
+                indexes.push_back({ "name", "method" });
+            }
+            else if (collection == "templates" || collection == "pages") {
+                indexes.push_back({ "name" });
+            }
 
-        std::string database_folder_path = _filesystem_config["root_path"].get_string() + '/' + database;
+            return indexes;
+        }
 
-        if (!boost::filesystem::exists(database_folder_path)) {
-            boost::filesystem::create_directory(database_folder_path);
+        if (index_config.is_array()) {
+            for (const auto& index : index_config) {
+                FilesystemIndexFields fields;
+
+                if (index.is_string()) {
+                    fields.push_back(index.get_string());
+                }
+                else if (index.is_array()) {
+                    for (const auto& field : index) {
+                        if (field.is_string()) {
+                            fields.push_back(field.get_string());
+                        }
+                    }
+                }
+
+                if (!fields.empty()) {
+                    indexes.push_back(fields);
+                }
+            }
         }
 
-        std::string collection_file_path = database_folder_path + '/' + collection + ".json";
+        return indexes;
+    }
+
+    void FilesystemBackend::find_matching(const FilesystemCollection& collection_data, const Maze::Element& simple_query,
+        const std::function<bool(int position, const Maze::Element& value)>& visitor) const {
+        const std::vector<int>* candidates = collection_data.find_candidates(simple_query);
+
+        if (candidates != nullptr) {
+            for (int position : *candidates) {
+                const Maze::Element& document = collection_data.document(position);
 
-        std::ofstream collection_file(collection_file_path, std::ofstream::trunc);
-        if (!collection_file.is_open()) {
-            throw Exceptions::StorageException(
-                "Unable to open collection file for " + database + "/" + collection);
+                if (check_if_matches_simple_query(document, simple_query) && !visitor(position, document)) {
+                    return;
+                }
+            }
+
+            return;
         }
 
-        collection_file << values.to_json(4);
-        collection_file.close();
+        for (int position = 0; position < collection_data.count(); ++position) {
+            const Maze::Element& document = collection_data.document(position);
+
+            if (check_if_matches_simple_query(document, simple_query) && !visitor(position, document)) {
+                return;
+            }
+        }
+    }
+
+    Maze::Element FilesystemBackend::parse_query(const std::string& json_simple_query) const {
+        try {
+            return Maze::Element::from_json(json_simple_query);
+        }
+        catch (...) {
+            throw Exceptions::StorageException("Invalid query syntax");
+        }
     }
 
     StorageBackendInterface* get_filesystem_backend() {
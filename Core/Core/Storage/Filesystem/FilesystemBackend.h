@@ -1,10 +1,26 @@
 #pragma once
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <Core/Storage/Storage.h>
+#include <Core/Storage/Filesystem/FilesystemCollection.h>
+#include <Core/Storage/Filesystem/FilesystemJsonLines.h>
+#include <Core/Storage/Filesystem/FilesystemMappedCollection.h>
+#include <Core/Storage/Filesystem/FilesystemSync.h>
+#include <Core/Storage/Filesystem/FilesystemWatcher.h>
+#include <Core/Storage/Filesystem/FilesystemWriteLog.h>
 #include <Maze/Maze.hpp>
 
 namespace Vortex::Core::Storage::Filesystem {
 
+    struct ResidentCollection {
+        std::shared_ptr<const FilesystemCollection> collection;
+        long long loaded_timestamp;
+    };
+
+
     class FilesystemBackend : public StorageBackendInterface {
     public:
         VORTEX_CORE_API FilesystemBackend();
@@ -20,21 +36,97 @@ namespace Vortex::Core::Storage::Filesystem {
         VORTEX_CORE_API virtual void simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
         VORTEX_CORE_API virtual void simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
 
+        // Structured query
+        VORTEX_CORE_API virtual void insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) override;
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual void replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) override;
+        VORTEX_CORE_API virtual void delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual void delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+
+        // Projected before the results are collected, the unselected fields of matches are never copied
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+
+        VORTEX_CORE_API virtual std::unique_ptr<StorageCursor> find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) override;
+
         VORTEX_CORE_API virtual const std::vector<std::string> get_database_list() override;
         VORTEX_CORE_API virtual const std::vector<std::string> get_collection_list(const std::string& database) override;
 
         VORTEX_CORE_API virtual bool database_exists(const std::string& database) override;
         VORTEX_CORE_API virtual bool collection_exists(const std::string& database, const std::string& collection) override;
 
+        // File I/O of async operations runs on its own io_threads sized pool
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool() override;
+
+        // Rewrites the collection in the given format and removes the file in the old one
+        VORTEX_CORE_API void convert_collection(const std::string& database, const std::string& collection, FilesystemCollectionFormat format);
+
     private:
         Maze::Element _filesystem_config;
         bool _cache_enabled = false;
         bool _in_memory_only = false;
         int _cache_expiry = 60;
+        // Format of newly created collections, existing ones keep the format of their file
+        FilesystemCollectionFormat _format = FilesystemCollectionFormat::Json;
+        FilesystemWatcher _watcher;
+        // Parsed collections with their indexes, reloaded after cache_expiry like the cached contents
+        bool _resident_collections = true;
+        mutable std::map<std::string, ResidentCollection> _resident;
+        mutable std::mutex _resident_mtx;
+        // Writers of a collection are serialized, readers work on immutable resident snapshots without locking
+        mutable std::map<std::string, std::mutex> _writer_mutexes;
+        mutable std::mutex _writer_mutexes_mtx;
+        // Collection files are memory mapped and indexed once, documents are parsed on access
+        bool _memory_mapping = true;
+        mutable std::map<std::string, std::shared_ptr<const FilesystemMappedCollection>> _mapped;
+        mutable std::mutex _mapped_mtx;
+        mutable FilesystemSync _sync;
+        // Files written by this backend, the watcher ignores events for them while they are unchanged
+        struct OwnWrite {
+            int pending = 0;
+            FileIdentity identity;
+        };
+        mutable std::map<std::string, OwnWrite> _own_writes;
+        mutable std::mutex _own_writes_mtx;
+        // Incremented after every change, contents read before a change finished are not cached
+        mutable std::map<std::string, unsigned long long> _generations;
+        mutable std::mutex _generations_mtx;
+        // Appends single operations instead of rewriting the whole collection file on every change
+        mutable FilesystemWriteLog _write_log;
+        int _io_threads = 4;
+        std::unique_ptr<boost::asio::thread_pool> _io_pool;
+        std::mutex _io_pool_mtx;
 
+        void on_collection_changed(const std::string& database, const std::string& collection, bool external_change) const;
         bool check_if_matches_simple_query(const Maze::Element& value, Maze::Element simple_query) const;
         Maze::Element get_collection_entries(const std::string& database, const std::string& collection) const;
-        void save_collection_entries(const std::string& database, const std::string& collection, const Maze::Element& values) const;
+        // The operation (see FilesystemWriteLog) is logged instead of writing all values when the write log is enabled
+        void save_collection_entries(const std::string& database, const std::string& collection, std::shared_ptr<const FilesystemCollection> collection_data,
+            const Maze::Element& operation = Maze::Element()) const;
+        Maze::Element load_collection_file(const std::string& database, const std::string& collection) const;
+        void write_collection_file(const std::string& database, const std::string& collection, const Maze::Element& values) const;
+        void write_own_file(const std::string& database, const std::string& collection, const std::string& path, const std::string& contents) const;
+        // True when the collection file is still the one last written by this backend or a write is in progress
+        bool is_own_write(const std::string& database, const std::string& collection) const;
+        FilesystemCollectionFormat get_collection_format(const std::string& database, const std::string& collection) const;
+        const std::string get_collection_file_path(const std::string& database, const std::string& collection, FilesystemCollectionFormat format) const;
+        std::shared_ptr<const FilesystemMappedCollection> get_mapped_collection(const std::string& database, const std::string& collection, FilesystemCollectionFormat format) const;
+        void remove_mapped_collection(const std::string& database, const std::string& collection) const;
+        // Documents can be parsed one by one straight from the collection file when nothing newer is held in memory or the log
+        bool can_stream(const std::string& database, const std::string& collection) const;
+        void scan_collection_file(const std::string& database, const std::string& collection,
+            const std::function<bool(int position, const Maze::Element& value)>& visitor) const;
+
+        // Writers get the latest stored contents instead of possibly stale cached ones
+        std::shared_ptr<const FilesystemCollection> get_collection(const std::string& database, const std::string& collection, bool for_write = false) const;
+        std::mutex& get_writer_mutex(const std::string& database, const std::string& collection) const;
+        void set_resident_collection(const std::string& database, const std::string& collection, std::shared_ptr<const FilesystemCollection> collection_data) const;
+        std::vector<FilesystemIndexFields> get_collection_indexes(const std::string& database, const std::string& collection) const;
+        // Calls the visitor with every document matching the query in collection order, until the visitor returns false
+        void find_matching(const FilesystemCollection& collection_data, const Maze::Element& simple_query,
+            const std::function<bool(int position, const Maze::Element& value)>& visitor) const;
+        Maze::Element parse_query(const std::string& json_simple_query) const;
     };
 
 
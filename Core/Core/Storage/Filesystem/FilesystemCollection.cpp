@@ -0,0 +1,346 @@
+#include <Core/Storage/Filesystem/FilesystemCollection.h>
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <Core/Util/String.h>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    namespace {
+
+        const std::vector<int> no_candidates;
+
+        // Missing fields and nulls share a key because null queries match both
+        bool scalar_key(const Maze::Element* value, std::string& key) {
+            if (value == nullptr || value->is_null()) {
+                key.append("n;");
+            }
+            else if (value->is_string()) {
+                const std::string& string_value = value->get_string();
+
+                key.append("s").append(std::to_string(string_value.length())).append(":").append(string_value);
+            }
+            else if (value->is_int() || value->is_double()) {
+                // Ints and doubles with the same value are the same key
+                std::ostringstream number;
+                number << std::setprecision(17) << (value->is_int() ? (double)value->get_int() : value->get_double());
+
+                key.append("d").append(number.str()).append(";");
+            }
+            else if (value->is_bool()) {
+                key.append(value->get_bool() ? "t;" : "f;");
+            }
+            else {
+                return false;
+            }
+
+            return true;
+        }
+
+        const Maze::Element* find_field(const Maze::Element& source, const std::string& field) {
+            const Maze::Element* current = &source;
+
+            for (const auto& part : Util::String::split(field, ".")) {
+                if (!current->is_object() || !current->exists(part)) {
+                    return nullptr;
+                }
+
+                current = &(*current)[part];
+            }
+
+            return current;
+        }
+
+    }  // namespace
+
+    FilesystemCollection::FilesystemCollection(const Maze::Element& documents, const std::vector<FilesystemIndexFields>& indexes) {
+        std::vector<std::shared_ptr<const Maze::Element>> parsed_documents;
+        parsed_documents.reserve(documents.count_children());
+
+        for (int i = 0; i < documents.count_children(); ++i) {
+            parsed_documents.push_back(std::make_shared<const Maze::Element>(documents[i]));
+        }
+
+        append_documents(parsed_documents);
+        build_indexes(indexes);
+    }
+
+    const Maze::Element& FilesystemCollection::document(int position) const {
+        return *(*_chunks[position / chunk_size])[position % chunk_size];
+    }
+
+    int FilesystemCollection::count() const {
+        return _count;
+    }
+
+    Maze::Element FilesystemCollection::documents() const {
+        Maze::Element documents(Maze::Type::Array);
+
+        for (const auto& chunk : _chunks) {
+            for (const auto& document : *chunk) {
+                documents.push_back(*document);
+            }
+        }
+
+        return documents;
+    }
+
+    std::shared_ptr<const FilesystemCollection> FilesystemCollection::inserted(const Maze::Element& value) const {
+        std::shared_ptr<FilesystemCollection> result(new FilesystemCollection(*this));
+        const int position = _count;
+
+        result->append_documents({ std::make_shared<const Maze::Element>(value) });
+
+        for (auto& index : result->_indexes) {
+            std::string key;
+
+            if (index_key(value, index.fields, false, key)) {
+                add_position(index, key, position);
+            }
+        }
+
+        return result;
+    }
+
+    std::shared_ptr<const FilesystemCollection> FilesystemCollection::replaced(int position, const Maze::Element& value) const {
+        std::shared_ptr<FilesystemCollection> result(new FilesystemCollection(*this));
+
+        for (auto& index : result->_indexes) {
+            std::string old_key, new_key;
+            const bool has_old_key = index_key(document(position), index.fields, false, old_key);
+            const bool has_new_key = index_key(value, index.fields, false, new_key);
+
+            if (has_old_key && has_new_key && old_key == new_key) {
+                continue;
+            }
+
+            if (has_old_key) {
+                remove_position(index, old_key, position);
+            }
+
+            if (has_new_key) {
+                add_position(index, new_key, position);
+            }
+        }
+
+        std::shared_ptr<DocumentChunk> chunk = std::make_shared<DocumentChunk>(*_chunks[position / chunk_size]);
+        (*chunk)[position % chunk_size] = std::make_shared<const Maze::Element>(value);
+        result->_chunks[position / chunk_size] = chunk;
+
+        return result;
+    }
+
+    std::shared_ptr<const FilesystemCollection> FilesystemCollection::removed(const std::vector<int>& positions) const {
+        if (positions.empty()) {
+            return std::shared_ptr<const FilesystemCollection>(new FilesystemCollection(*this));
+        }
+
+        std::shared_ptr<FilesystemCollection> result(new FilesystemCollection());
+        const int first_removed = positions.front();
+        const int first_chunk = first_removed / chunk_size;
+
+        // Chunks before the first removed document keep their positions
+        result->_chunks.assign(_chunks.begin(), _chunks.begin() + first_chunk);
+        result->_count = first_chunk * chunk_size;
+
+        std::vector<std::shared_ptr<const Maze::Element>> remaining_documents;
+        remaining_documents.reserve(_count - result->_count);
+
+        auto removed_it = std::lower_bound(positions.begin(), positions.end(), result->_count);
+        for (int i = result->_count; i < _count; ++i) {
+            if (removed_it != positions.end() && *removed_it == i) {
+                ++removed_it;
+            }
+            else {
+                remaining_documents.push_back((*_chunks[i / chunk_size])[i % chunk_size]);
+            }
+        }
+
+        result->append_documents(remaining_documents);
+
+        // Remaining positions move down by the number of removed documents before them, entries which only
+        // have positions before the first removed document are shared
+        for (const auto& index : _indexes) {
+            Index patched_index{ index.fields, {} };
+
+            for (const auto& shard : index.shards) {
+                std::shared_ptr<IndexShard> patched_shard;
+
+                for (const auto& entry : *shard) {
+                    if (entry.second->back() < first_removed) {
+                        continue;
+                    }
+
+                    if (!patched_shard) {
+                        patched_shard = std::make_shared<IndexShard>(*shard);
+                    }
+
+                    std::shared_ptr<std::vector<int>> entry_positions = std::make_shared<std::vector<int>>();
+                    entry_positions->reserve(entry.second->size());
+
+                    for (int position : *entry.second) {
+                        const auto& it = std::lower_bound(positions.begin(), positions.end(), position);
+
+                        if (it == positions.end() || *it != position) {
+                            entry_positions->push_back(position - (int)(it - positions.begin()));
+                        }
+                    }
+
+                    if (entry_positions->empty()) {
+                        patched_shard->erase(entry.first);
+                    }
+                    else {
+                        (*patched_shard)[entry.first] = entry_positions;
+                    }
+                }
+
+                patched_index.shards.push_back(patched_shard ? patched_shard : shard);
+            }
+
+            result->_indexes.push_back(std::move(patched_index));
+        }
+
+        return result;
+    }
+
+    const std::vector<int>* FilesystemCollection::find_candidates(const Maze::Element& query) const {
+        const Index* best_index = nullptr;
+        std::string best_key;
+
+        // Index covering the most query fields is the most selective one
+        for (const auto& index : _indexes) {
+            std::string key;
+
+            if ((best_index == nullptr || index.fields.size() > best_index->fields.size()) &&
+                index_key(query, index.fields, true, key)) {
+                best_index = &index;
+                best_key = key;
+            }
+        }
+
+        if (best_index == nullptr) {
+            return nullptr;
+        }
+
+        const IndexShard& shard = *best_index->shards[shard_of(best_key)];
+        const auto& it = shard.find(best_key);
+
+        return it != shard.end() ? it->second.get() : &no_candidates;
+    }
+
+    void FilesystemCollection::append_documents(const std::vector<std::shared_ptr<const Maze::Element>>& documents) {
+        size_t next = 0;
+
+        // The last chunk is shared with the previous version, so it is copied before it is filled up
+        if (_count % chunk_size != 0 && !documents.empty()) {
+            std::shared_ptr<DocumentChunk> chunk = std::make_shared<DocumentChunk>(*_chunks.back());
+
+            while (next < documents.size() && chunk->size() < (size_t)chunk_size) {
+                chunk->push_back(documents[next++]);
+            }
+
+            _chunks.back() = chunk;
+        }
+
+        while (next < documents.size()) {
+            std::shared_ptr<DocumentChunk> chunk = std::make_shared<DocumentChunk>();
+            chunk->reserve(chunk_size);
+
+            while (next < documents.size() && chunk->size() < (size_t)chunk_size) {
+                chunk->push_back(documents[next++]);
+            }
+
+            _chunks.push_back(chunk);
+        }
+
+        _count += (int)documents.size();
+    }
+
+    void FilesystemCollection::build_indexes(const std::vector<FilesystemIndexFields>& indexes) {
+        for (const auto& fields : indexes) {
+            std::vector<std::unordered_map<std::string, std::vector<int>>> entries(index_shard_count);
+
+            for (int i = 0; i < _count; ++i) {
+                std::string key;
+
+                if (index_key(document(i), fields, false, key)) {
+                    entries[shard_of(key)][key].push_back(i);
+                }
+            }
+
+            Index index{ fields, {} };
+
+            for (auto& shard_entries : entries) {
+                std::shared_ptr<IndexShard> shard = std::make_shared<IndexShard>();
+
+                for (auto& entry : shard_entries) {
+                    shard->emplace(entry.first, std::make_shared<const std::vector<int>>(std::move(entry.second)));
+                }
+
+                index.shards.push_back(shard);
+            }
+
+            _indexes.push_back(std::move(index));
+        }
+    }
+
+    bool FilesystemCollection::index_key(const Maze::Element& source, const FilesystemIndexFields& fields, bool is_query, std::string& key) {
+        for (const auto& field : fields) {
+            const Maze::Element* value = find_field(source, field);
+
+            // Queries can only use the index when they constrain every field with a scalar
+            if (is_query && value == nullptr) {
+                return false;
+            }
+
+            if (!scalar_key(value, key)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t FilesystemCollection::shard_of(const std::string& key) {
+        return std::hash<std::string>()(key) % index_shard_count;
+    }
+
+    void FilesystemCollection::add_position(Index& index, const std::string& key, int position) {
+        std::shared_ptr<const IndexShard>& shard = index.shards[shard_of(key)];
+        std::shared_ptr<IndexShard> patched_shard = std::make_shared<IndexShard>(*shard);
+
+        const auto& it = patched_shard->find(key);
+        std::shared_ptr<std::vector<int>> positions = (it != patched_shard->end()) ?
+            std::make_shared<std::vector<int>>(*it->second) : std::make_shared<std::vector<int>>();
+
+        // Positions stay in ascending order
+        positions->insert(std::lower_bound(positions->begin(), positions->end(), position), position);
+
+        (*patched_shard)[key] = positions;
+        shard = patched_shard;
+    }
+
+    void FilesystemCollection::remove_position(Index& index, const std::string& key, int position) {
+        std::shared_ptr<const IndexShard>& shard = index.shards[shard_of(key)];
+        if (shard->find(key) == shard->end()) {
+            return;
+        }
+
+        std::shared_ptr<IndexShard> patched_shard = std::make_shared<IndexShard>(*shard);
+        const auto& it = patched_shard->find(key);
+
+        std::shared_ptr<std::vector<int>> positions = std::make_shared<std::vector<int>>(*it->second);
+        positions->erase(std::lower_bound(positions->begin(), positions->end(), position));
+
+        if (positions->empty()) {
+            patched_shard->erase(it);
+        }
+        else {
+            it->second = positions;
+        }
+
+        shard = patched_shard;
+    }
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    // Dotted field paths of one (compound) index, e.g. { "name", "method" } or { "_id.$oid" }
+    typedef std::vector<std::string> FilesystemIndexFields;
+
+
+    // Parsed collection kept in memory together with hash indexes on configured fields.
+    // Instances are immutable once built so they can be shared between readers. Writes derive a new version
+    // which shares everything it doesn't change: documents are stored in fixed size chunks and index entries
+    // in shards, so an insert or replace copies one chunk and the shards (and position lists) of the changed keys.
+    // Removing shifts the positions after the first removed document, so that still rebuilds the rest.
+    class FilesystemCollection {
+    public:
+        FilesystemCollection(const Maze::Element& documents, const std::vector<FilesystemIndexFields>& indexes);
+
+        const Maze::Element& document(int position) const;
+        int count() const;
+        // Copies every document into a new array, only needed when the whole collection is serialized
+        Maze::Element documents() const;
+
+        std::shared_ptr<const FilesystemCollection> inserted(const Maze::Element& value) const;
+        std::shared_ptr<const FilesystemCollection> replaced(int position, const Maze::Element& value) const;
+        // Positions have to be in ascending order
+        std::shared_ptr<const FilesystemCollection> removed(const std::vector<int>& positions) const;
+
+        // Positions (in ascending order) of documents that can match the query, nullptr when no index applies.
+        // Candidates still have to be checked against the full query.
+        const std::vector<int>* find_candidates(const Maze::Element& query) const;
+
+    private:
+        static const int chunk_size = 256;
+        static const int index_shard_count = 64;
+
+        // Every chunk except the last one is full
+        typedef std::vector<std::shared_ptr<const Maze::Element>> DocumentChunk;
+        typedef std::unordered_map<std::string, std::shared_ptr<const std::vector<int>>> IndexShard;
+
+        struct Index {
+            FilesystemIndexFields fields;
+            std::vector<std::shared_ptr<const IndexShard>> shards;
+        };
+
+        std::vector<std::shared_ptr<const DocumentChunk>> _chunks;
+        int _count = 0;
+        std::vector<Index> _indexes;
+
+        FilesystemCollection() = default;
+
+        void append_documents(const std::vector<std::shared_ptr<const Maze::Element>>& documents);
+        void build_indexes(const std::vector<FilesystemIndexFields>& indexes);
+
+        static bool index_key(const Maze::Element& source, const FilesystemIndexFields& fields, bool is_query, std::string& key);
+        static size_t shard_of(const std::string& key);
+        static void add_position(Index& index, const std::string& key, int position);
+        static void remove_position(Index& index, const std::string& key, int position);
+    };
+
+}  // namespace Vortex::Core::Storage::Filesystem
@@ -0,0 +1,63 @@
+#include <Core/Storage/Filesystem/FilesystemJsonLines.h>
+#include <fstream>
+#include <Core/Exceptions/StorageException.h>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    void FilesystemJsonLines::scan(const std::string& path, const std::function<bool(int position, const Maze::Element& value)>& visitor) {
+        std::ifstream collection_file(path, std::ifstream::binary);
+        if (!collection_file.is_open()) {
+            throw Exceptions::StorageException("Unable to open collection file " + path);
+        }
+
+        int position = 0;
+        std::string line;
+
+        while (std::getline(collection_file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            // Blank lines don't hold a document and don't take a position
+            if (line.find_first_not_of(" \t") == std::string::npos) {
+                continue;
+            }
+
+            Maze::Element value;
+            try {
+                value = Maze::Element::from_json(line);
+            }
+            catch (...) {
+                throw Exceptions::StorageException("Collection file is corrupted (unable to parse json on document " + std::to_string(position) + ")");
+            }
+
+            if (!visitor(position++, value)) {
+                return;
+            }
+        }
+    }
+
+    Maze::Element FilesystemJsonLines::read(const std::string& path) {
+        Maze::Element values(Maze::Type::Array);
+
+        scan(path, [&values](int position, const Maze::Element& value) {
+            values.push_back(value);
+
+            return true;
+            });
+
+        return values;
+    }
+
+    const std::string FilesystemJsonLines::serialize(const Maze::Element& values) {
+        std::string result;
+
+        for (const auto& value : values) {
+            result += value.to_json(0);
+            result += '\n';
+        }
+
+        return result;
+    }
+
+}
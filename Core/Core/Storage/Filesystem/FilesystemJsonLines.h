@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    enum class FilesystemCollectionFormat {
+        // One json array per file (<collection>.json)
+        Json,
+        // One json document per line (<collection>.jsonl)
+        JsonLines
+    };
+
+
+    // Reading and writing of collections stored in the JSON Lines format
+    class FilesystemJsonLines {
+    public:
+        // Parses one document at a time and calls the visitor with it until the visitor returns false
+        static void scan(const std::string& path, const std::function<bool(int position, const Maze::Element& value)>& visitor);
+        static Maze::Element read(const std::string& path);
+        static const std::string serialize(const Maze::Element& values);
+    };
+
+}  // namespace Vortex::Core::Storage::Filesystem
@@ -0,0 +1,208 @@
+#include <Core/Storage/Filesystem/FilesystemMappedCollection.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <Core/Exceptions/StorageException.h>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    namespace {
+
+        // Mapping costs more than copying for small files and copies are not affected by external writers
+        const uint64_t mapping_threshold = 64 * 1024;
+
+        bool is_whitespace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        size_t skip_whitespace(const char* data, size_t length, size_t position) {
+            while (position < length && is_whitespace(data[position])) {
+                ++position;
+            }
+
+            return position;
+        }
+
+    }  // namespace
+
+    FilesystemMappedCollection::FilesystemMappedCollection(const std::string& path, FilesystemCollectionFormat format) : _path(path) {
+        _identity = FileIdentity::of(path);
+
+        if (!_identity.exists) {
+            throw Exceptions::StorageException("Unable to open collection file " + path);
+        }
+
+        // Empty files can not be mapped and don't contain any documents
+        if (_identity.size == 0) {
+            return;
+        }
+
+        size_t length = 0;
+
+        if (_identity.size < mapping_threshold) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                throw Exceptions::StorageException("Unable to open collection file " + path);
+            }
+
+            std::stringstream contents;
+            contents << file.rdbuf();
+            _contents = contents.str();
+            length = _contents.size();
+        }
+        else {
+            try {
+                _file = boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only);
+                _region = boost::interprocess::mapped_region(_file, boost::interprocess::read_only);
+            }
+            catch (const boost::interprocess::interprocess_exception& e) {
+                throw Exceptions::StorageException("Unable to map collection file " + path + ": " + e.what());
+            }
+
+            // Documents will be read sequentially
+            _region.advise(boost::interprocess::mapped_region::advice_sequential);
+            length = _region.get_size();
+        }
+
+        if (format == FilesystemCollectionFormat::JsonLines) {
+            index_json_lines(data(), length);
+        }
+        else {
+            index_json_array(data(), length);
+        }
+    }
+
+    const size_t FilesystemMappedCollection::size() const {
+        return _offsets.size();
+    }
+
+    Maze::Element FilesystemMappedCollection::document(size_t position) const {
+        const auto& offsets = _offsets.at(position);
+
+        try {
+            return Maze::Element::from_json(std::string(data() + offsets.first, offsets.second - offsets.first));
+        }
+        catch (...) {
+            throw Exceptions::StorageException("Collection file is corrupted (unable to parse json on document " + std::to_string(position) + ")");
+        }
+    }
+
+    Maze::Element FilesystemMappedCollection::documents() const {
+        Maze::Element values(Maze::Type::Array);
+
+        for (size_t position = 0; position < _offsets.size(); ++position) {
+            values.push_back(document(position));
+        }
+
+        return values;
+    }
+
+    void FilesystemMappedCollection::scan(const std::function<bool(int position, const Maze::Element& value)>& visitor) const {
+        for (size_t position = 0; position < _offsets.size(); ++position) {
+            if (!visitor((int)position, document(position))) {
+                return;
+            }
+        }
+    }
+
+    const bool FilesystemMappedCollection::is_current() const {
+        // Replacing the file changes the inode, writes within the same second still change the nanoseconds
+        return FileIdentity::of(_path) == _identity;
+    }
+
+    const char* FilesystemMappedCollection::data() const {
+        return _contents.empty() ? static_cast<const char*>(_region.get_address()) : _contents.data();
+    }
+
+    void FilesystemMappedCollection::index_json_array(const char* data, size_t length) {
+        size_t position = skip_whitespace(data, length, 0);
+
+        if (position >= length || data[position] != '[') {
+            throw Exceptions::StorageException("Collection file is corrupted (expected json array) " + _path);
+        }
+
+        position = skip_whitespace(data, length, position + 1);
+
+        if (position < length && data[position] == ']') {
+            return;
+        }
+
+        // Only strings and nesting are tracked, the documents themselves are validated when parsed
+        while (position < length) {
+            const size_t begin = position;
+            int depth = 0;
+            bool in_string = false;
+
+            for (; position < length; ++position) {
+                const char c = data[position];
+
+                if (in_string) {
+                    if (c == '\\') {
+                        ++position;
+                    }
+                    else if (c == '"') {
+                        in_string = false;
+                    }
+                }
+                else if (c == '"') {
+                    in_string = true;
+                }
+                else if (c == '{' || c == '[') {
+                    ++depth;
+                }
+                else if (c == '}' || c == ']') {
+                    if (depth == 0) {
+                        break;
+                    }
+
+                    --depth;
+                }
+                else if (c == ',' && depth == 0) {
+                    break;
+                }
+            }
+
+            if (position >= length) {
+                throw Exceptions::StorageException("Collection file is corrupted (unterminated json array) " + _path);
+            }
+
+            size_t end = position;
+            while (end > begin && is_whitespace(data[end - 1])) {
+                --end;
+            }
+
+            _offsets.push_back(std::make_pair(begin, end));
+
+            if (data[position] == ']') {
+                return;
+            }
+
+            position = skip_whitespace(data, length, position + 1);
+        }
+
+        throw Exceptions::StorageException("Collection file is corrupted (unterminated json array) " + _path);
+    }
+
+    void FilesystemMappedCollection::index_json_lines(const char* data, size_t length) {
+        size_t begin = 0;
+
+        while (begin < length) {
+            const char* line_end = static_cast<const char*>(memchr(data + begin, '\n', length - begin));
+            size_t end = (line_end != nullptr) ? (size_t)(line_end - data) : length;
+            const size_t next = end + 1;
+
+            while (end > begin && is_whitespace(data[end - 1])) {
+                --end;
+            }
+
+            // Blank lines don't hold a document and don't take a position
+            const size_t document_begin = skip_whitespace(data, end, begin);
+            if (document_begin < end) {
+                _offsets.push_back(std::make_pair(document_begin, end));
+            }
+
+            begin = next;
+        }
+    }
+
+}
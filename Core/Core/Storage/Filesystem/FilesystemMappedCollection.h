@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <Core/Storage/Filesystem/FilesystemJsonLines.h>
+#include <Core/Storage/Filesystem/FilesystemSync.h>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    // Read-only memory mapped collection file with an index of document boundaries.
+    // Documents are parsed only when accessed, the mapped pages are shared through the page cache.
+    // Files written through the backend are replaced with a rename, which keeps the mapped file intact. External
+    // writers have to do the same, truncating a mapped file in place makes accessing it fail with SIGBUS.
+    // Small files are copied into memory instead of being mapped.
+    class FilesystemMappedCollection {
+    public:
+        FilesystemMappedCollection(const std::string& path, FilesystemCollectionFormat format);
+
+        const size_t size() const;
+        Maze::Element document(size_t position) const;
+        Maze::Element documents() const;
+        // Parses documents in collection order until the visitor returns false
+        void scan(const std::function<bool(int position, const Maze::Element& value)>& visitor) const;
+
+        // False once the file was replaced or modified after it was mapped
+        const bool is_current() const;
+
+    private:
+        std::string _path;
+        FileIdentity _identity;
+        boost::interprocess::file_mapping _file;
+        boost::interprocess::mapped_region _region;
+        // Contents of files below the mapping threshold
+        std::string _contents;
+        // Begin and end offset of every document
+        std::vector<std::pair<size_t, size_t>> _offsets;
+
+        const char* data() const;
+        void index_json_array(const char* data, size_t length);
+        void index_json_lines(const char* data, size_t length);
+    };
+
+}  // namespace Vortex::Core::Storage::Filesystem
@@ -0,0 +1,243 @@
+#include <Core/Storage/Filesystem/FilesystemSync.h>
+#include <fcntl.h>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <boost/filesystem.hpp>
+#include <Core/Exceptions/StorageException.h>
+#include <Core/Logging.h>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    FileIdentity FileIdentity::of(const std::string& path) {
+        FileIdentity identity;
+
+#ifdef _WIN32
+        boost::system::error_code ec;
+        const uintmax_t size = boost::filesystem::file_size(path, ec);
+        if (ec) {
+            return identity;
+        }
+        const std::time_t last_write_time = boost::filesystem::last_write_time(path, ec);
+        if (ec) {
+            return identity;
+        }
+
+        identity.size = size;
+        identity.last_write_nanos = static_cast<int64_t>(last_write_time) * 1000000000;
+#else
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) {
+            return identity;
+        }
+
+        identity.inode = static_cast<uint64_t>(st.st_ino);
+        identity.size = static_cast<uint64_t>(st.st_size);
+#ifdef __APPLE__
+        identity.last_write_nanos = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+        identity.last_write_nanos = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+
+        identity.exists = true;
+        return identity;
+    }
+
+    bool FileIdentity::operator==(const FileIdentity& other) const {
+        return exists == other.exists && inode == other.inode && size == other.size && last_write_nanos == other.last_write_nanos;
+    }
+
+    bool FileIdentity::operator!=(const FileIdentity& other) const {
+        return !(*this == other);
+    }
+
+
+    FilesystemSync::FilesystemSync() {}
+
+    FilesystemSync::~FilesystemSync() {
+        stop();
+    }
+
+    void FilesystemSync::set_config(const Maze::Element& durability_config) {
+        if (durability_config.is_string("fsync")) {
+            const std::string policy = durability_config["fsync"].get_string();
+
+            if (policy == "always") {
+                _policy = FsyncPolicy::Always;
+            }
+            else if (policy == "interval" || policy == "interval_ms") {
+                _policy = FsyncPolicy::Interval;
+            }
+            else if (policy == "never") {
+                _policy = FsyncPolicy::Never;
+            }
+            else {
+                VORTEX_WARN("Unknown fsync policy {0}, using interval", policy);
+            }
+        }
+
+        if (durability_config.is_int("fsync_interval_ms") && durability_config["fsync_interval_ms"].get_int() > 0) {
+            _interval_ms = durability_config["fsync_interval_ms"].get_int();
+        }
+
+        if (_policy == FsyncPolicy::Interval && !_running.exchange(true)) {
+            _thread = std::thread(&FilesystemSync::run, this);
+        }
+    }
+
+    const FsyncPolicy FilesystemSync::policy() const {
+        return _policy;
+    }
+
+    FileIdentity FilesystemSync::write_file(const std::string& path, const std::string& contents) {
+        // Readers and crashes only ever see the old or the new file, never a partially written one
+        const std::string temp_path = path + ".tmp";
+
+        std::ofstream file(temp_path, std::ofstream::trunc | std::ofstream::binary);
+        if (!file.is_open()) {
+            throw Exceptions::StorageException("Unable to open " + temp_path + " for writing");
+        }
+
+        file << contents;
+        file.close();
+
+        if (file.fail()) {
+            throw Exceptions::StorageException("Unable to write " + temp_path);
+        }
+
+        // The data has to be durable before the rename makes it visible, otherwise a crash before the background
+        // sync can leave an empty or partial file under the final name. Only the directory sync is deferred.
+        if (_policy != FsyncPolicy::Never && !sync_path(temp_path)) {
+            throw Exceptions::StorageException("Unable to sync " + temp_path);
+        }
+
+        // Rename keeps the inode and timestamps, so this is also the identity of the replaced file
+        const FileIdentity identity = FileIdentity::of(temp_path);
+
+        boost::system::error_code ec;
+        boost::filesystem::rename(temp_path, path, ec);
+        if (ec) {
+            throw Exceptions::StorageException("Unable to replace " + path + ": " + ec.message());
+        }
+
+        // The rename itself is persisted with the directory
+        written(boost::filesystem::path(path).parent_path().string());
+
+        return identity;
+    }
+
+    void FilesystemSync::append_file(const std::string& path, const std::string& contents) {
+        std::ofstream file(path, std::ofstream::app | std::ofstream::binary);
+        if (!file.is_open()) {
+            throw Exceptions::StorageException("Unable to open " + path + " for appending");
+        }
+
+        file << contents;
+        file.close();
+
+        if (file.fail()) {
+            throw Exceptions::StorageException("Unable to append to " + path);
+        }
+
+        written(path);
+    }
+
+    void FilesystemSync::written(const std::string& path) {
+        if (_policy == FsyncPolicy::Always) {
+            if (!sync_path(path)) {
+                throw Exceptions::StorageException("Unable to sync " + path);
+            }
+        }
+        else if (_policy == FsyncPolicy::Interval) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            _dirty_paths.insert(path);
+        }
+    }
+
+    void FilesystemSync::flush(const std::string& path) {
+        if (_policy != FsyncPolicy::Never && !sync_path(path)) {
+            throw Exceptions::StorageException("Unable to sync " + path);
+        }
+    }
+
+    void FilesystemSync::stop() {
+        if (!_running) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _running = false;
+        }
+        _cv.notify_all();
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+
+        sync_dirty_paths();
+    }
+
+    void FilesystemSync::run() {
+        std::unique_lock<std::mutex> lock(_mtx);
+
+        while (_running) {
+            _cv.wait_for(lock, std::chrono::milliseconds(_interval_ms), [this]() { return !_running; });
+
+            lock.unlock();
+            sync_dirty_paths();
+            lock.lock();
+        }
+    }
+
+    void FilesystemSync::sync_dirty_paths() {
+        std::set<std::string> dirty_paths;
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            dirty_paths.swap(_dirty_paths);
+        }
+
+        for (const auto& path : dirty_paths) {
+            if (!sync_path(path)) {
+                VORTEX_WARN("Unable to sync {0}", path);
+            }
+        }
+    }
+
+    bool FilesystemSync::sync_path(const std::string& path) {
+#ifdef _WIN32
+        // Directories can not be flushed on windows, renames are journaled by NTFS
+        if (boost::filesystem::is_directory(path)) {
+            return true;
+        }
+
+        int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+        if (fd < 0) {
+            return false;
+        }
+
+        bool synced = (_commit(fd) == 0);
+        _close(fd);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            // Files removed by compaction in the meantime don't need to be synced
+            return !boost::filesystem::exists(path);
+        }
+
+        bool synced = (::fsync(fd) == 0);
+        ::close(fd);
+#endif
+
+        return synced;
+    }
+
+}
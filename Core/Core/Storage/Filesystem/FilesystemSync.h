@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    enum class FsyncPolicy {
+        // Every write is flushed to the device before it is acknowledged
+        Always,
+        // Written files are flushed in the background every fsync_interval_ms
+        Interval,
+        // Flushing is left to the operating system
+        Never
+    };
+
+
+    // Identifies one version of a file, a rename or in-place write changes at least one of the fields
+    struct FileIdentity {
+        bool exists = false;
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t last_write_nanos = 0;
+
+        static FileIdentity of(const std::string& path);
+
+        bool operator==(const FileIdentity& other) const;
+        bool operator!=(const FileIdentity& other) const;
+    };
+
+
+    // Crash safe file writes (temp file + rename) with a configurable fsync policy
+    class FilesystemSync {
+    public:
+        FilesystemSync();
+        ~FilesystemSync();
+
+        void set_config(const Maze::Element& durability_config);
+        const FsyncPolicy policy() const;
+
+        // Returns the identity of the written file, taken before the rename made it visible
+        FileIdentity write_file(const std::string& path, const std::string& contents);
+        void append_file(const std::string& path, const std::string& contents);
+        // Called after path was written, flushes it according to the policy
+        void written(const std::string& path);
+        // Flushes path right away unless the policy is Never, for writes that later writes depend on
+        void flush(const std::string& path);
+
+        void stop();
+
+    private:
+        FsyncPolicy _policy = FsyncPolicy::Interval;
+        int _interval_ms = 1000;
+        std::set<std::string> _dirty_paths;
+        std::mutex _mtx;
+        std::condition_variable _cv;
+        std::thread _thread;
+        std::atomic<bool> _running{ false };
+
+        void run();
+        void sync_dirty_paths();
+
+        static bool sync_path(const std::string& path);
+    };
+
+}  // namespace Vortex::Core::Storage::Filesystem
@@ -0,0 +1,146 @@
+#include <Core/Storage/Filesystem/FilesystemWatcher.h>
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+#include <Core/Logging.h>
+#include <Core/Util/String.h>
+#include <boost/filesystem.hpp>
+#include <boost/range/iterator_range.hpp>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    FilesystemWatcher::FilesystemWatcher() {}
+
+    FilesystemWatcher::~FilesystemWatcher() {
+        stop();
+    }
+
+    void FilesystemWatcher::start(const std::string& root_path, const CollectionChangedHandler& handler) {
+        if (_running) {
+            return;
+        }
+
+#ifdef __linux__
+        _root_path = root_path;
+        _handler = handler;
+
+        _inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_inotify_fd < 0) {
+            VORTEX_ERROR("Unable to initialize inotify for {0}", root_path);
+
+            return;
+        }
+
+        _root_watch = inotify_add_watch(_inotify_fd, root_path.c_str(), IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR);
+        if (_root_watch < 0) {
+            VORTEX_ERROR("Unable to watch storage root_path {0}", root_path);
+            close(_inotify_fd);
+            _inotify_fd = -1;
+
+            return;
+        }
+
+        for (const auto& dir_entry : boost::make_iterator_range(boost::filesystem::directory_iterator(root_path), {})) {
+            if (boost::filesystem::is_directory(dir_entry.status())) {
+                watch_database(dir_entry.path().filename().string());
+            }
+        }
+
+        _running = true;
+        _thread = std::thread(&FilesystemWatcher::run, this);
+#else
+        VORTEX_WARN("Filesystem change watching is only supported on linux.");
+#endif
+    }
+
+    void FilesystemWatcher::stop() {
+        _running = false;
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+
+#ifdef __linux__
+        if (_inotify_fd >= 0) {
+            close(_inotify_fd);
+            _inotify_fd = -1;
+        }
+#endif
+
+        _database_watches.clear();
+    }
+
+    const bool FilesystemWatcher::is_running() const {
+        return _running;
+    }
+
+    void FilesystemWatcher::watch_database(const std::string& database) {
+#ifdef __linux__
+        const std::string database_path = _root_path + "/" + database;
+
+        int watch = inotify_add_watch(_inotify_fd, database_path.c_str(),
+            IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR);
+
+        if (watch >= 0) {
+            _database_watches[watch] = database;
+        }
+#endif
+    }
+
+    void FilesystemWatcher::run() {
+#ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+
+        while (_running) {
+            pollfd poll_fd{ _inotify_fd, POLLIN, 0 };
+
+            // Timeout is needed so the thread notices stop() requests
+            if (poll(&poll_fd, 1, 500) <= 0) {
+                continue;
+            }
+
+            ssize_t length = read(_inotify_fd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                continue;
+            }
+
+            for (char* ptr = buffer; ptr < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                const std::string name = event->len > 0 ? event->name : "";
+
+                if (event->wd == _root_watch) {
+                    if (event->mask & IN_ISDIR) {
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                            watch_database(name);
+                        }
+
+                        _handler(name, "", ChangeType::Modified);
+                    }
+                }
+                else {
+                    const auto& it = _database_watches.find(event->wd);
+
+                    if (it == _database_watches.end()) {
+                        continue;
+                    }
+
+                    if (event->mask & IN_IGNORED) {
+                        _database_watches.erase(it);
+                    }
+                    else if (Util::String::ends_with(name, ".json")) {
+                        _handler(it->second, name.substr(0, name.length() - 5), ChangeType::Modified);
+                    }
+                    else if (Util::String::ends_with(name, ".jsonl")) {
+                        _handler(it->second, name.substr(0, name.length() - 6), ChangeType::Modified);
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <Core/Storage/ChangeFeed.h>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    // Watches the storage root_path for collection files that were changed outside of the backend.
+    // Only supported on linux (inotify), on other platforms start() does nothing.
+    class FilesystemWatcher {
+    public:
+        FilesystemWatcher();
+        ~FilesystemWatcher();
+
+        void start(const std::string& root_path, const CollectionChangedHandler& handler);
+        void stop();
+        const bool is_running() const;
+
+    private:
+        std::string _root_path;
+        CollectionChangedHandler _handler;
+        std::thread _thread;
+        std::atomic<bool> _running{ false };
+        int _inotify_fd = -1;
+        int _root_watch = -1;
+        std::map<int, std::string> _database_watches;
+
+        void watch_database(const std::string& database);
+        void run();
+    };
+
+}  // namespace Vortex::Core::Storage::Filesystem
@@ -0,0 +1,447 @@
+#include <Core/Storage/Filesystem/FilesystemWriteLog.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <Core/Exceptions/StorageException.h>
+#include <Core/Logging.h>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    namespace {
+
+        std::string fnv1a_hex(const std::string& value) {
+            uint64_t hash = 14695981039346656037ULL;
+
+            for (const char c : value) {
+                hash ^= (unsigned char)c;
+                hash *= 1099511628211ULL;
+            }
+
+            char buffer[17];
+            std::snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)hash);
+
+            return buffer;
+        }
+
+        std::string read_file(const std::string& path) {
+            std::ifstream file(path, std::ifstream::binary);
+            if (!file.is_open()) {
+                return "";
+            }
+
+            std::stringstream contents;
+            contents << file.rdbuf();
+
+            return contents.str();
+        }
+
+        unsigned long long get_sequence(const Maze::Element& element) {
+            return element.is_int("seq") && element["seq"].get_int() > 0 ? (unsigned long long)element["seq"].get_int() : 0;
+        }
+
+    }  // namespace
+
+    FilesystemWriteLog::FilesystemWriteLog(FilesystemSync& sync) : _sync(sync) {}
+
+    FilesystemWriteLog::~FilesystemWriteLog() {
+        stop();
+    }
+
+    void FilesystemWriteLog::set_config(const std::string& root_path, const Maze::Element& write_log_config) {
+        _root_path = root_path;
+
+        if (write_log_config.is_bool("enabled")) {
+            _enabled = write_log_config["enabled"].get_bool();
+        }
+
+        if (write_log_config.is_int("compaction_interval") && write_log_config["compaction_interval"].get_int() > 0) {
+            _compaction_interval = write_log_config["compaction_interval"].get_int();
+        }
+
+        if (write_log_config.is_int("compaction_threshold_kb") && write_log_config["compaction_threshold_kb"].get_int() > 0) {
+            _compaction_threshold = (size_t)write_log_config["compaction_threshold_kb"].get_int() * 1024;
+        }
+    }
+
+    const bool FilesystemWriteLog::is_enabled() const {
+        return _enabled;
+    }
+
+    void FilesystemWriteLog::start(const CompactionHandler& compaction_handler) {
+        if (_running.exchange(true)) {
+            return;
+        }
+
+        _compaction_handler = compaction_handler;
+        _thread = std::thread(&FilesystemWriteLog::run, this);
+    }
+
+    void FilesystemWriteLog::stop() {
+        if (!_running) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _running = false;
+        }
+        _cv.notify_all();
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+
+        // Leave base files complete on shutdown
+        compact_pending(false);
+    }
+
+    const bool FilesystemWriteLog::has_log(const std::string& database, const std::string& collection) const {
+        return boost::filesystem::exists(log_path(database, collection));
+    }
+
+    void FilesystemWriteLog::append(const std::string& database, const std::string& collection, const Maze::Element& operation) {
+        std::unique_lock<std::mutex> lock(_mtx);
+
+        const unsigned long long sequence = ++_appended_sequence;
+        _batch.push_back(FilesystemLogAppend{ std::make_pair(database, collection), operation.to_json(0) + "\n", sequence });
+
+        while (_committed_sequence < sequence) {
+            if (_flushing) {
+                _commit_cv.wait(lock);
+                continue;
+            }
+
+            // No flush is in progress, this writer commits everything queued so far
+            _flushing = true;
+            lock.unlock();
+            flush_batch();
+            lock.lock();
+        }
+
+        const auto& failed = _failed_appends.find(sequence);
+        if (failed != _failed_appends.end()) {
+            const std::string message = failed->second;
+            _failed_appends.erase(failed);
+
+            throw Exceptions::StorageException(message);
+        }
+    }
+
+    void FilesystemWriteLog::replay(const std::string& database, const std::string& collection, const std::string& base_path, Maze::Element& documents) {
+        std::lock_guard<std::recursive_mutex> file_lock(_file_mtx);
+
+        std::ifstream log_file(log_path(database, collection), std::ifstream::binary);
+        if (!log_file.is_open()) {
+            return;
+        }
+
+        // The base was rewritten with the logged operations up to the checkpoint, but the log was not removed
+        unsigned long long applied_sequence = 0;
+        const Maze::Element checkpoint = read_checkpoint(database, collection);
+        if (checkpoint.is_string("base_hash") && checkpoint["base_hash"].get_string() == fnv1a_hex(read_file(base_path))) {
+            applied_sequence = get_sequence(checkpoint);
+        }
+
+        unsigned long long last_sequence = get_sequence(checkpoint);
+        size_t log_size = 0;
+        std::string line;
+
+        while (std::getline(log_file, line)) {
+            log_size += line.length() + 1;
+
+            if (line.empty()) {
+                continue;
+            }
+
+            Maze::Element operation;
+            try {
+                operation = Maze::Element::from_json(line);
+            }
+            catch (...) {
+                // Only the last line can be incomplete (crash during append), everything before it is valid
+                VORTEX_WARN("Ignoring incomplete write log entry of {0}/{1}", database, collection);
+                break;
+            }
+
+            // Operations logged before sequence numbers were introduced have none and are always applied
+            const unsigned long long sequence = get_sequence(operation);
+            last_sequence = std::max(last_sequence, sequence);
+            if (sequence != 0 && sequence <= applied_sequence) {
+                continue;
+            }
+
+            const std::string type = operation.is_string("op") ? operation["op"].get_string() : "";
+
+            // A position outside of the collection means the log doesn't belong to this base file, applying the
+            // remaining operations would corrupt the collection
+            const auto check_position = [&](const Maze::Element& position) {
+                if (!position.is_int() || position.get_int() < 0 || position.get_int() >= documents.count_children()) {
+                    throw Exceptions::StorageException("Write log of " + database + "/" + collection +
+                        " does not match the collection file (position out of range in " + line + ")");
+                }
+
+                return position.get_int();
+            };
+
+            if (type == "insert") {
+                documents.push_back(operation["value"]);
+            }
+            else if (type == "replace") {
+                documents[check_position(operation["position"])] = operation["value"];
+            }
+            else if (type == "delete" && operation.is_array("positions")) {
+                // Positions are stored in descending order
+                for (const auto& position : operation["positions"]) {
+                    documents.remove_at(check_position(position));
+                }
+            }
+        }
+
+        unsigned long long& logged_sequence = _log_sequences[std::make_pair(database, collection)];
+        logged_sequence = std::max(logged_sequence, last_sequence);
+
+        if (log_size > 0) {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            _pending[std::make_pair(database, collection)] = log_size;
+        }
+    }
+
+    void FilesystemWriteLog::checkpoint(const std::string& database, const std::string& collection, const std::string& base_contents) {
+        std::lock_guard<std::recursive_mutex> file_lock(_file_mtx);
+
+        if (!has_log(database, collection)) {
+            return;
+        }
+
+        const Maze::Element checkpoint({ "seq", "base_hash" }, {
+            Maze::Element((int)log_sequence(database, collection)), Maze::Element(fnv1a_hex(base_contents)) });
+
+        _sync.write_file(checkpoint_path(database, collection), checkpoint.to_json(0));
+
+        // The checkpoint has to be visible before the base file it describes is
+        _sync.flush(_root_path + "/" + database);
+    }
+
+    void FilesystemWriteLog::clear(const std::string& database, const std::string& collection) {
+        std::lock_guard<std::recursive_mutex> file_lock(_file_mtx);
+
+        const std::string path = log_path(database, collection);
+        const std::string checkpoint = checkpoint_path(database, collection);
+
+        if (boost::filesystem::exists(path) || boost::filesystem::exists(checkpoint)) {
+            // The rewritten base file has to be durable before the operations it contains are dropped
+            _sync.flush(_root_path + "/" + database);
+
+            boost::system::error_code ec;
+            boost::filesystem::remove(path, ec);
+            boost::filesystem::remove(checkpoint, ec);
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _pending.erase(std::make_pair(database, collection));
+    }
+
+    void FilesystemWriteLog::compact(const std::string& database, const std::string& collection) {
+        // Appends wait until the base file is rewritten and the log removed, so no operation is lost
+        std::lock_guard<std::recursive_mutex> file_lock(_file_mtx);
+
+        try {
+            if (_compaction_handler) {
+                _compaction_handler(database, collection);
+            }
+
+            clear(database, collection);
+        }
+        catch (const std::exception& e) {
+            VORTEX_ERROR("Write log compaction of {0}/{1} failed: {2}", database, collection, e.what());
+        }
+    }
+
+    Maze::Element FilesystemWriteLog::insert_operation(const Maze::Element& value) {
+        return Maze::Element({ "op", "value" }, { Maze::Element("insert"), value });
+    }
+
+    Maze::Element FilesystemWriteLog::replace_operation(int position, const Maze::Element& value) {
+        return Maze::Element({ "op", "position", "value" }, { Maze::Element("replace"), Maze::Element(position), value });
+    }
+
+    Maze::Element FilesystemWriteLog::delete_operation(const std::vector<int>& positions) {
+        Maze::Element descending_positions(Maze::Type::Array);
+
+        for (auto it = positions.rbegin(); it != positions.rend(); ++it) {
+            descending_positions.push_back(Maze::Element(*it));
+        }
+
+        return Maze::Element({ "op", "positions" }, { Maze::Element("delete"), descending_positions });
+    }
+
+    const std::string FilesystemWriteLog::log_path(const std::string& database, const std::string& collection) const {
+        return _root_path + "/" + database + "/" + collection + ".log";
+    }
+
+    const std::string FilesystemWriteLog::checkpoint_path(const std::string& database, const std::string& collection) const {
+        return log_path(database, collection) + ".checkpoint";
+    }
+
+    Maze::Element FilesystemWriteLog::read_checkpoint(const std::string& database, const std::string& collection) const {
+        const std::string contents = read_file(checkpoint_path(database, collection));
+        if (contents.empty()) {
+            return Maze::Element(Maze::Type::Object);
+        }
+
+        try {
+            return Maze::Element::from_json(contents);
+        }
+        catch (...) {
+            // Checkpoints are replaced atomically, an unreadable one was not written by the write log
+            VORTEX_WARN("Ignoring corrupted write log checkpoint of {0}/{1}", database, collection);
+
+            return Maze::Element(Maze::Type::Object);
+        }
+    }
+
+    unsigned long long& FilesystemWriteLog::log_sequence(const std::string& database, const std::string& collection) {
+        const auto key = std::make_pair(database, collection);
+
+        auto it = _log_sequences.find(key);
+        if (it != _log_sequences.end()) {
+            return it->second;
+        }
+
+        // Sequences continue after the ones in the log and a leftover checkpoint, otherwise new operations could
+        // be mistaken for ones the base file already contains
+        unsigned long long sequence = get_sequence(read_checkpoint(database, collection));
+
+        std::ifstream log_file(log_path(database, collection), std::ifstream::binary);
+        std::string line;
+        while (std::getline(log_file, line)) {
+            try {
+                sequence = std::max(sequence, get_sequence(Maze::Element::from_json(line)));
+            }
+            catch (...) {
+                break;
+            }
+        }
+
+        return _log_sequences.emplace(key, sequence).first->second;
+    }
+
+    void FilesystemWriteLog::flush_batch() {
+        std::lock_guard<std::recursive_mutex> file_lock(_file_mtx);
+
+        std::vector<FilesystemLogAppend> batch;
+        unsigned long long last_sequence;
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            batch.swap(_batch);
+            last_sequence = _appended_sequence;
+        }
+
+        // Lines of the same collection are joined so each log is written and synced once per batch.
+        // Sequences are assigned here, in the order the lines are written.
+        std::map<std::pair<std::string, std::string>, std::string> log_contents;
+        std::map<std::pair<std::string, std::string>, unsigned long long> last_sequences;
+        for (const auto& append : batch) {
+            unsigned long long& sequence = last_sequences[append.collection];
+            if (sequence == 0) {
+                sequence = log_sequence(append.collection.first, append.collection.second);
+            }
+
+            // Lines are compact json objects, the sequence is added as their first field
+            log_contents[append.collection] += "{\"seq\":" + std::to_string(++sequence) + "," + append.line.substr(1);
+        }
+
+        std::map<std::pair<std::string, std::string>, std::string> failures;
+        for (const auto& log : log_contents) {
+            try {
+                _sync.append_file(log_path(log.first.first, log.first.second), log.second);
+
+                log_sequence(log.first.first, log.first.second) = last_sequences[log.first];
+            }
+            catch (const std::exception& e) {
+                failures[log.first] = std::string("Unable to append to write log of ") +
+                    log.first.first + "/" + log.first.second + ": " + e.what();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        bool compaction_needed = false;
+        for (const auto& log : log_contents) {
+            if (failures.find(log.first) != failures.end()) {
+                continue;
+            }
+
+            size_t& pending_size = _pending[log.first];
+            pending_size += log.second.length();
+
+            compaction_needed = compaction_needed || pending_size >= _compaction_threshold;
+        }
+
+        for (const auto& append : batch) {
+            const auto& failure = failures.find(append.collection);
+
+            if (failure != failures.end()) {
+                _failed_appends[append.sequence] = failure->second;
+            }
+        }
+
+        _committed_sequence = last_sequence;
+        _flushing = false;
+        _commit_cv.notify_all();
+
+        if (compaction_needed) {
+            _cv.notify_all();
+        }
+    }
+
+    void FilesystemWriteLog::run() {
+        std::unique_lock<std::mutex> lock(_mtx);
+        auto next_compaction = std::chrono::steady_clock::now() + std::chrono::seconds(_compaction_interval);
+
+        while (_running) {
+            _cv.wait_until(lock, next_compaction);
+
+            if (!_running) {
+                break;
+            }
+
+            const bool interval_elapsed = std::chrono::steady_clock::now() >= next_compaction;
+
+            // Compaction locks the log files, which must never happen while _mtx is held
+            lock.unlock();
+            compact_pending(!interval_elapsed);
+            lock.lock();
+
+            if (interval_elapsed) {
+                next_compaction = std::chrono::steady_clock::now() + std::chrono::seconds(_compaction_interval);
+            }
+        }
+    }
+
+    void FilesystemWriteLog::compact_pending(bool only_over_threshold) {
+        std::vector<std::pair<std::string, std::string>> collections;
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+
+            for (const auto& pending : _pending) {
+                if (!only_over_threshold || pending.second >= _compaction_threshold) {
+                    collections.push_back(pending.first);
+                }
+            }
+        }
+
+        for (const auto& collection : collections) {
+            compact(collection.first, collection.second);
+        }
+    }
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Core/Storage/Filesystem/FilesystemSync.h>
+#include <Maze/Maze.hpp>
+
+namespace Vortex::Core::Storage::Filesystem {
+
+    struct FilesystemLogAppend {
+        std::pair<std::string, std::string> collection;
+        std::string line;
+        unsigned long long sequence;
+    };
+
+
+    // Writes the collection (base file + replayed log) back to its base file, the log is removed afterwards
+    typedef std::function<void(const std::string& database, const std::string& collection)> CompactionHandler;
+
+
+    // Append-only operation log next to each collection file (<collection>.log), one json operation per line.
+    // Logged operations are replayed over the base file on load and folded into it by background compaction.
+    // Concurrent appends are group committed: one writer flushes the whole batch with a single sync per file.
+    //
+    // Every logged operation has a sequence number. Before a base file is rewritten, a checkpoint
+    // (<collection>.log.checkpoint) records the last logged sequence together with a hash of the new base. If the
+    // process crashes before the log is removed, replay finds the hash matching and skips the operations the base
+    // already contains instead of applying them twice.
+    class FilesystemWriteLog {
+    public:
+        FilesystemWriteLog(FilesystemSync& sync);
+        ~FilesystemWriteLog();
+
+        void set_config(const std::string& root_path, const Maze::Element& write_log_config);
+        const bool is_enabled() const;
+
+        void start(const CompactionHandler& compaction_handler);
+        void stop();
+
+        const bool has_log(const std::string& database, const std::string& collection) const;
+        void append(const std::string& database, const std::string& collection, const Maze::Element& operation);
+        void replay(const std::string& database, const std::string& collection, const std::string& base_path, Maze::Element& documents);
+        // Must be called before the base file is rewritten with the full collection (base + replayed log)
+        void checkpoint(const std::string& database, const std::string& collection, const std::string& base_contents);
+        // Must only be called after the base file was rewritten with the full collection
+        void clear(const std::string& database, const std::string& collection);
+        void compact(const std::string& database, const std::string& collection);
+
+        static Maze::Element insert_operation(const Maze::Element& value);
+        static Maze::Element replace_operation(int position, const Maze::Element& value);
+        static Maze::Element delete_operation(const std::vector<int>& positions);
+
+    private:
+        bool _enabled = false;
+        std::string _root_path;
+        int _compaction_interval = 30;
+        size_t _compaction_threshold = 1024 * 1024;
+        CompactionHandler _compaction_handler;
+        FilesystemSync& _sync;
+        // Log size of every collection with operations that are not compacted yet
+        std::map<std::pair<std::string, std::string>, size_t> _pending;
+        std::mutex _mtx;
+        // Serializes log file writes with compaction, always locked before _mtx
+        std::recursive_mutex _file_mtx;
+        // Last sequence number written to the log of every collection, guarded by _file_mtx
+        std::map<std::pair<std::string, std::string>, unsigned long long> _log_sequences;
+        std::thread _thread;
+        std::atomic<bool> _running{ false };
+        std::condition_variable _cv;
+
+        // Group commit state, guarded by _mtx
+        std::vector<FilesystemLogAppend> _batch;
+        unsigned long long _appended_sequence = 0;
+        unsigned long long _committed_sequence = 0;
+        std::map<unsigned long long, std::string> _failed_appends;
+        bool _flushing = false;
+        std::condition_variable _commit_cv;
+
+        const std::string log_path(const std::string& database, const std::string& collection) const;
+        const std::string checkpoint_path(const std::string& database, const std::string& collection) const;
+        Maze::Element read_checkpoint(const std::string& database, const std::string& collection) const;
+        unsigned long long& log_sequence(const std::string& database, const std::string& collection);
+        void flush_batch();
+        void run();
+        void compact_pending(bool only_over_threshold);
+    };
+
+}  // namespace Vortex::Core::Storage::Filesystem
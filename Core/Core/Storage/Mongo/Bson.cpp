@@ -0,0 +1,150 @@
+#include <Core/Storage/Mongo/Bson.h>
+#ifdef HAS_FEATURE_MONGOCXX
+#include <chrono>
+#include <limits>
+#include <bsoncxx/builder/core.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#endif
+
+namespace Vortex::Core::Storage::Mongo {
+
+#ifdef HAS_FEATURE_MONGOCXX
+    namespace {
+
+        // Document and array elements share the accessors but not a public base class
+        template<typename BsonElement>
+        Maze::Element value_to_element(const BsonElement& element) {
+            switch (element.type()) {
+            case bsoncxx::type::k_utf8:
+                return Maze::Element(element.get_utf8().value.to_string());
+            case bsoncxx::type::k_int32:
+                return Maze::Element((int)element.get_int32().value);
+            case bsoncxx::type::k_int64: {
+                const int64_t value = element.get_int64().value;
+
+                // Maze integers are 32 bit
+                if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) {
+                    return Maze::Element((int)value);
+                }
+
+                return Maze::Element((double)value);
+            }
+            case bsoncxx::type::k_double:
+                return Maze::Element(element.get_double().value);
+            case bsoncxx::type::k_bool:
+                return Maze::Element(element.get_bool().value);
+            case bsoncxx::type::k_oid:
+                return Maze::Element({ "$oid" }, { Maze::Element(element.get_oid().value.to_string()) });
+            case bsoncxx::type::k_date:
+                return Maze::Element({ "$date" }, { Maze::Element((double)element.get_date().to_int64()) });
+            case bsoncxx::type::k_decimal128:
+                return Maze::Element({ "$numberDecimal" }, { Maze::Element(element.get_decimal128().value.to_string()) });
+            case bsoncxx::type::k_timestamp:
+                return Maze::Element({ "$timestamp" }, { Maze::Element({ "t", "i" }, {
+                    Maze::Element((double)element.get_timestamp().timestamp),
+                    Maze::Element((double)element.get_timestamp().increment) }) });
+            case bsoncxx::type::k_regex:
+                return Maze::Element({ "$regex", "$options" }, {
+                    Maze::Element(element.get_regex().regex.to_string()),
+                    Maze::Element(element.get_regex().options.to_string()) });
+            case bsoncxx::type::k_document:
+                return bson_to_element(element.get_document().value);
+            case bsoncxx::type::k_array:
+                return bson_to_element(element.get_array().value);
+            default:
+                // Null, undefined and types without a Maze representation (binary, code, ...)
+                return Maze::Element(Maze::Type::Null);
+            }
+        }
+
+        void append_value(bsoncxx::builder::core& builder, const Maze::Element& value) {
+            switch (value.get_type()) {
+            case Maze::Type::Bool:
+                builder.append(value.get_bool());
+                break;
+            case Maze::Type::Int:
+                builder.append((int32_t)value.get_int());
+                break;
+            case Maze::Type::Double:
+                builder.append(value.get_double());
+                break;
+            case Maze::Type::String:
+                builder.append(value.get_string());
+                break;
+            case Maze::Type::Array:
+                builder.open_array();
+
+                for (const auto& child : value) {
+                    append_value(builder, child);
+                }
+
+                builder.close_array();
+                break;
+            case Maze::Type::Object:
+                // Extended json values written by bson_to_element
+                if (value.count_children() == 1 && value.is_string("$oid")) {
+                    builder.append(bsoncxx::oid(value["$oid"].get_string()));
+                }
+                else if (value.count_children() == 1 && (value.is_double("$date") || value.is_int("$date"))) {
+                    const double millis = value.is_int("$date") ? value["$date"].get_int() : value["$date"].get_double();
+
+                    builder.append(bsoncxx::types::b_date(std::chrono::milliseconds((int64_t)millis)));
+                }
+                else if (value.count_children() == 1 && value.is_string("$numberLong")) {
+                    builder.append((int64_t)std::stoll(value["$numberLong"].get_string()));
+                }
+                else {
+                    builder.open_document();
+
+                    for (auto it = value.keys_begin(); it != value.keys_end(); ++it) {
+                        builder.key_owned(*it);
+                        append_value(builder, value[*it]);
+                    }
+
+                    builder.close_document();
+                }
+                break;
+            default:
+                builder.append(bsoncxx::types::b_null{});
+                break;
+            }
+        }
+
+    }  // namespace
+
+    Maze::Element bson_to_element(bsoncxx::document::view document) {
+        Maze::Element result(Maze::Type::Object);
+
+        for (const auto& element : document) {
+            result.set(element.key().to_string(), value_to_element(element));
+        }
+
+        return result;
+    }
+
+    Maze::Element bson_to_element(bsoncxx::array::view array) {
+        Maze::Element result(Maze::Type::Array);
+
+        for (const auto& element : array) {
+            result.push_back(value_to_element(element));
+        }
+
+        return result;
+    }
+
+    bsoncxx::document::value element_to_bson(const Maze::Element& document) {
+        bsoncxx::builder::core builder(false);
+
+        if (document.is_object()) {
+            for (auto it = document.keys_begin(); it != document.keys_end(); ++it) {
+                builder.key_owned(*it);
+                append_value(builder, document[*it]);
+            }
+        }
+
+        return builder.extract_document();
+    }
+#endif
+
+}
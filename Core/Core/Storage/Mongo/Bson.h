@@ -0,0 +1,21 @@
+#pragma once
+
+#ifdef HAS_FEATURE_MONGOCXX
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#endif
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Storage::Mongo {
+
+#ifdef HAS_FEATURE_MONGOCXX
+    // Direct conversion between bson and Maze elements without json text in between.
+    // Object ids and dates use the extended json form ({ "$oid": "..." }, { "$date": millis }) the runtime expects.
+    VORTEX_CORE_API Maze::Element bson_to_element(bsoncxx::document::view document);
+    VORTEX_CORE_API Maze::Element bson_to_element(bsoncxx::array::view array);
+    VORTEX_CORE_API bsoncxx::document::value element_to_bson(const Maze::Element& document);
+#endif
+
+}  // namespace Vortex::Core::Storage::Mongo
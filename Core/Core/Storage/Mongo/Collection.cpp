@@ -1,35 +1,164 @@
 #include <Core/Storage/Mongo/Collection.h>
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#include <algorithm>
+#ifdef HAS_FEATURE_MONGOCXX
 #include <bsoncxx/json.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/options/find.hpp>
 #endif
 #include <Maze/Maze.hpp>
+#include <Core/Storage/Mongo/Bson.h>
 
 namespace Vortex::Core::Storage::Mongo {
 
+#ifdef HAS_FEATURE_MONGOCXX
+    namespace {
+
+        class MongoCursor : public StorageCursor {
+        public:
+            MongoCursor(std::shared_ptr<mongocxx::client> client, mongocxx::cursor cursor, const QueryOptions& options)
+                : _client(client), _cursor(std::move(cursor)), _it(_cursor.begin()), _options(options) {}
+
+            virtual Maze::Element next_batch() override {
+                Maze::Element batch(Maze::Type::Array);
+
+                for (int i = 0; i < std::max(_options.batch_size, 1) && _it != _cursor.end(); ++i, ++_it) {
+                    Maze::Element document = bson_to_element(*_it);
+
+                    _last_keyset = _options.keyset(document);
+                    batch.push_back(_options.project(document));
+                }
+
+                return batch;
+            }
+
+            virtual const bool has_more() override {
+                return _it != _cursor.end();
+            }
+
+        private:
+            // The cursor uses the pooled client until it is destroyed
+            std::shared_ptr<mongocxx::client> _client;
+            mongocxx::cursor _cursor;
+            mongocxx::cursor::iterator _it;
+            QueryOptions _options;
+        };
+
+        // Documents after the keyset: (a > x) or (a == x and b > y) ...
+        Maze::Element keyset_query(const QueryOptions& options) {
+            const std::vector<std::pair<std::string, int>> fields = options.keyset_fields();
+            Maze::Element or_query(Maze::Type::Array);
+
+            for (size_t i = 0; i < fields.size(); ++i) {
+                Maze::Element condition(Maze::Type::Object);
+
+                for (size_t j = 0; j < i; ++j) {
+                    condition.set(fields[j].first, QueryOptions::get_field(options.after, fields[j].first));
+                }
+
+                condition.set(fields[i].first, Maze::Element(
+                    { fields[i].second > 0 ? "$gt" : "$lt" },
+                    { QueryOptions::get_field(options.after, fields[i].first) }));
+
+                or_query.push_back(condition);
+            }
+
+            return Maze::Element({ "$or" }, { or_query });
+        }
+
+    }  // namespace
+#endif
+
     Collection::Collection() {}
 
-#ifdef VORTEX_HAS_FEATURE_MONGO
-    Collection::Collection(mongocxx::collection collection)
-        : _collection(collection) {}
+#ifdef HAS_FEATURE_MONGOCXX
+    Collection::Collection(std::shared_ptr<mongocxx::client> client, mongocxx::collection collection)
+        : _client(client), _collection(collection) {}
 #endif
 
-    Maze::Element Collection::find(const Maze::Element& query) {
-        return find(query.to_json());
+    Maze::Element Collection::find(const Maze::Element& query, const Maze::Element& projection) {
+        Maze::Element results(Maze::Type::Array);
+
+#ifdef HAS_FEATURE_MONGOCXX
+        mongocxx::options::find find_options;
+        if (projection.has_children()) {
+            find_options.projection(element_to_bson(projection));
+        }
+
+        auto values = _collection.find(element_to_bson(query), find_options);
+        for (auto it = values.begin(); it != values.end(); it++) {
+            results << bson_to_element(*it);
+        }
+#endif
+
+        return results;
     }
 
     Maze::Element Collection::find(const std::string& json_query) {
         Maze::Element results(Maze::Type::Array);
 
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         auto values = _collection.find(bsoncxx::from_json(json_query));
         for (auto it = values.begin(); it != values.end(); it++) {
-            results << Maze::Element::from_json(bsoncxx::to_json(*it));
+            results << bson_to_element(*it);
         }
 #endif
 
         return results;
     }
 
+    std::unique_ptr<StorageCursor> Collection::find(const Maze::Element& query, const QueryOptions& options) {
+#ifdef HAS_FEATURE_MONGOCXX
+        mongocxx::options::find find_options;
+        const std::vector<std::pair<std::string, int>> fields = options.keyset_fields();
+
+        if (options.limit > 0) {
+            find_options.limit(options.limit);
+        }
+
+        if (options.skip > 0) {
+            find_options.skip(options.skip);
+        }
+
+        find_options.batch_size(std::max(options.batch_size, 1));
+
+        if (!fields.empty()) {
+            Maze::Element sort(Maze::Type::Object);
+
+            for (const auto& field : fields) {
+                sort.set(field.first, Maze::Element(field.second));
+            }
+
+            find_options.sort(element_to_bson(sort));
+        }
+
+        if (options.projection.has_children()) {
+            // Keyset fields have to be returned to continue with the next page, they are removed by the cursor
+            Maze::Element projection = options.projection;
+            const bool inclusion = options.is_inclusion_projection();
+
+            for (const auto& field : fields) {
+                if (inclusion) {
+                    projection.set(field.first, Maze::Element(1));
+                }
+                else if (projection.exists(field.first)) {
+                    projection.remove(field.first);
+                }
+            }
+
+            if (projection.has_children()) {
+                find_options.projection(element_to_bson(projection));
+            }
+        }
+
+        Maze::Element filter = options.after.has_children() ?
+            Maze::Element({ "$and" }, { Maze::Element(std::vector<Maze::Element>{ query, keyset_query(options) }) }) : query;
+
+        return std::make_unique<MongoCursor>(_client, _collection.find(element_to_bson(filter), find_options), options);
+#else
+        return std::make_unique<DocumentCursor>(std::make_shared<const Maze::Element>(Maze::Type::Array), std::vector<int>(), options);
+#endif
+    }
+
     Maze::Element Collection::find_by_id(const std::string& oid) {
         Maze::Element query(
             { "id" },
@@ -39,16 +168,29 @@ namespace Vortex::Core::Storage::Mongo {
         return find_one(query);
     }
 
-    Maze::Element Collection::find_one(const Maze::Element& query) {
-        return find_one(query.to_json());
+    Maze::Element Collection::find_one(const Maze::Element& query, const Maze::Element& projection) {
+#ifdef HAS_FEATURE_MONGOCXX
+        mongocxx::options::find find_options;
+        if (projection.has_children()) {
+            find_options.projection(element_to_bson(projection));
+        }
+
+        auto value = _collection.find_one(element_to_bson(query), find_options);
+
+        if (value) {
+            return bson_to_element(value->view());
+        }
+#endif
+
+        return Maze::Element(Maze::Type::Object);
     }
 
     Maze::Element Collection::find_one(const std::string& json_query) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         auto value = _collection.find_one(bsoncxx::from_json(json_query));
 
         if (value) {
-            return Maze::Element::from_json(bsoncxx::to_json(value.value()));
+            return bson_to_element(value->view());
         }
 #endif
 
@@ -56,47 +198,57 @@ namespace Vortex::Core::Storage::Mongo {
     }
 
     void Collection::delete_one(const Maze::Element& query) {
-        delete_one(query.to_json());
+#ifdef HAS_FEATURE_MONGOCXX
+        _collection.delete_one(element_to_bson(query));
+#endif
     }
 
     void Collection::delete_one(const std::string& json_query) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         _collection.delete_one(bsoncxx::from_json(json_query));
 #endif
     }
 
     void Collection::delete_many(const Maze::Element& query) {
-        delete_many(query.to_json());
+#ifdef HAS_FEATURE_MONGOCXX
+        _collection.delete_many(element_to_bson(query));
+#endif
     }
 
     void Collection::delete_many(const std::string& json_query) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         _collection.delete_many(bsoncxx::from_json(json_query));
 #endif
     }
 
     void Collection::insert_one(const Maze::Element& value) {
-        insert_one(value.to_json());
+#ifdef HAS_FEATURE_MONGOCXX
+        _collection.insert_one(element_to_bson(value));
+#endif
     }
 
     void Collection::insert_one(const std::string& json_value) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         _collection.insert_one(bsoncxx::from_json(json_value));
 #endif
     }
 
     void Collection::insert_many(const Maze::Element& values) {
-        std::vector<std::string> json_values;
+#ifdef HAS_FEATURE_MONGOCXX
+        std::vector<bsoncxx::document::value> bson_values;
 
         for (auto it = values.begin(); it != values.end(); it++) {
-            json_values.push_back(it->to_json());
+            bson_values.push_back(element_to_bson(*it));
         }
 
-        insert_many(json_values);
+        if (!bson_values.empty()) {
+            _collection.insert_many(bson_values);
+        }
+#endif
     }
 
     void Collection::insert_many(const std::vector<std::string>& json_values_array) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         std::vector<bsoncxx::document::value> bson_values;
 
         for (auto it = json_values_array.begin(); it != json_values_array.end(); it++) {
@@ -108,11 +260,13 @@ namespace Vortex::Core::Storage::Mongo {
     }
 
     void Collection::replace_one(const Maze::Element& query, const Maze::Element& replacement_value) {
-        replace_one(query.to_json(), replacement_value.to_json());
+#ifdef HAS_FEATURE_MONGOCXX
+        _collection.replace_one(element_to_bson(query), element_to_bson(replacement_value));
+#endif
     }
 
     void Collection::replace_one(const std::string& json_query, const std::string& json_replacement_value) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         _collection.replace_one(bsoncxx::from_json(json_query), bsoncxx::from_json(json_replacement_value));
 #endif
     }
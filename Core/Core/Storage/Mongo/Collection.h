@@ -1,25 +1,31 @@
 #pragma once
 
+#include <memory>
 #include <string>
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
+#include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
 #endif
 #include <Maze/Maze.hpp>
 #include <Core/DLLSupport.h>
+#include <Core/Storage/Cursor.h>
+#include <Core/Storage/QueryOptions.h>
 
 namespace Vortex::Core::Storage::Mongo {
 
 	class Collection {
 	public:
 		Collection();
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		Collection(mongocxx::collection collection);
+#ifdef HAS_FEATURE_MONGOCXX
+		Collection(std::shared_ptr<mongocxx::client> client, mongocxx::collection collection);
 #endif
 
-		VORTEX_CORE_API Maze::Element find(const Maze::Element& query);
+		// Projection is applied by the server, an empty one returns whole documents
+		VORTEX_CORE_API Maze::Element find(const Maze::Element& query, const Maze::Element& projection = Maze::Element(Maze::Type::Object));
 		VORTEX_CORE_API Maze::Element find(const std::string& json_query);
+		VORTEX_CORE_API std::unique_ptr<StorageCursor> find(const Maze::Element& query, const QueryOptions& options);
 		VORTEX_CORE_API Maze::Element find_by_id(const std::string& oid);
-		VORTEX_CORE_API Maze::Element find_one(const Maze::Element& query);
+		VORTEX_CORE_API Maze::Element find_one(const Maze::Element& query, const Maze::Element& projection = Maze::Element(Maze::Type::Object));
 		VORTEX_CORE_API Maze::Element find_one(const std::string& json_query);
 
 		VORTEX_CORE_API void delete_many(const Maze::Element& query);
@@ -37,7 +43,9 @@ namespace Vortex::Core::Storage::Mongo {
 		VORTEX_CORE_API void replace_one(const std::string& json_query, const std::string& json_replacement_value);
 
 	private:
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
+		// Pooled client the collection belongs to
+		std::shared_ptr<mongocxx::client> _client;
 		mongocxx::collection _collection;
 #endif
 	};
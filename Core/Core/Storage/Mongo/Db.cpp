@@ -4,14 +4,14 @@ namespace Vortex::Core::Storage::Mongo {
 
 	Db::Db() {}
 
-#ifdef VORTEX_HAS_FEATURE_MONGO
-	Db::Db(mongocxx::database database) 
-		: _database(database) {}
+#ifdef HAS_FEATURE_MONGOCXX
+	Db::Db(std::shared_ptr<mongocxx::client> client, mongocxx::database database)
+		: _client(client), _database(database) {}
 #endif
 
 	Collection Db::get_collection(const std::string& collection_name) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		return Collection(_database[collection_name]);
+#ifdef HAS_FEATURE_MONGOCXX
+		return Collection(_client, _database[collection_name]);
 #else
 		return Collection();
 #endif
@@ -20,7 +20,7 @@ namespace Vortex::Core::Storage::Mongo {
 	std::vector<std::string> Db::list_collections() {
 		std::vector<std::string> collections;
 
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
 		auto colls = _database.list_collections();
 		for (auto it = colls.begin(); it != colls.end(); it++) {
 			collections.push_back((*it)["name"].get_utf8().value.to_string());
@@ -31,7 +31,7 @@ namespace Vortex::Core::Storage::Mongo {
 	}
 
 	void Db::drop_database() {
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
 		_database.drop();
 #endif
 	}
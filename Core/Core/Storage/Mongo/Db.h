@@ -1,8 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
+#include <mongocxx/client.hpp>
 #include <mongocxx/database.hpp>
 #endif
 #include <Core/Storage/Mongo/Collection.h>
@@ -15,8 +17,8 @@ namespace Vortex::Core::Storage::Mongo {
     class Db {
     public:
         Db();
-#ifdef VORTEX_HAS_FEATURE_MONGO
-        Db(mongocxx::database database);
+#ifdef HAS_FEATURE_MONGOCXX
+        Db(std::shared_ptr<mongocxx::client> client, mongocxx::database database);
 #endif
 
         VORTEX_CORE_API Collection get_collection(const std::string& collection_name);
@@ -26,7 +28,9 @@ namespace Vortex::Core::Storage::Mongo {
         VORTEX_CORE_API void drop_database();
 
     private:
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
+        // Pooled client the database belongs to
+        std::shared_ptr<mongocxx::client> _client;
         mongocxx::database _database;
 #endif
     };
@@ -1,22 +1,37 @@
 #include <Core/Storage/Mongo/Mongo.h>
+#include <algorithm>
+#ifdef HAS_FEATURE_MONGOCXX
+#include <chrono>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/uri.hpp>
+#endif
+#include <Core/Exceptions/StorageException.h>
+#include <Core/Logging.h>
 
 namespace Vortex::Core::Storage::Mongo {
 
-	Mongo::Mongo() {
-		connect();
-	}
+	Mongo::Mongo() {}
 
 	Mongo::Mongo(const Maze::Element& mongo_config) {
 		set_config(mongo_config);
 		connect();
 	}
 
+	Mongo::~Mongo() {
+		stop_watching();
+	}
+
 	void Mongo::connect() {
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		if (enabled) {
-			mongocxx::uri uri{ get_connection_uri() };
+#ifdef HAS_FEATURE_MONGOCXX
+		std::lock_guard<std::mutex> lock(_pool_mtx);
 
-			client_ = mongocxx::client{ uri };
+		// Clients acquired from an existing pool may still be in use, so it is never replaced
+		if (_enabled && !_pool) {
+			_pool = std::make_unique<mongocxx::pool>(mongocxx::uri{ get_connection_uri() });
 		}
 #endif
 	}
@@ -52,8 +67,29 @@ namespace Vortex::Core::Storage::Mongo {
 			}
 		}
 
+		uri += "/";
+
 		if (_mongo_config.is_string("database")) {
-			uri += "/" + _mongo_config["database"].get_string();
+			uri += _mongo_config["database"].get_string();
+		}
+
+		const Maze::Element& pool_config = _mongo_config.get_const_ref("pool", Maze::Type::Object);
+		std::vector<std::string> pool_options;
+
+		if (pool_config.is_int("min_size")) {
+			pool_options.push_back("minPoolSize=" + std::to_string(pool_config["min_size"].get_int()));
+		}
+
+		if (pool_config.is_int("max_size")) {
+			pool_options.push_back("maxPoolSize=" + std::to_string(pool_config["max_size"].get_int()));
+		}
+
+		if (pool_config.is_int("wait_timeout_ms")) {
+			pool_options.push_back("waitQueueTimeoutMS=" + std::to_string(pool_config["wait_timeout_ms"].get_int()));
+		}
+
+		for (size_t i = 0; i < pool_options.size(); ++i) {
+			uri += (i == 0 ? "?" : "&") + pool_options[i];
 		}
 
 		return uri;
@@ -71,9 +107,26 @@ namespace Vortex::Core::Storage::Mongo {
 		}
 	}
 
+	int Mongo::get_executor_thread_count() {
+		const Maze::Element& pool_config = _mongo_config.get_const_ref("pool", Maze::Type::Object);
+		int thread_count = 8;
+
+		if (pool_config.is_int("executor_threads") && pool_config["executor_threads"].get_int() > 0) {
+			thread_count = pool_config["executor_threads"].get_int();
+		}
+
+		if (pool_config.is_int("max_size") && pool_config["max_size"].get_int() > 0) {
+			thread_count = std::min(thread_count, pool_config["max_size"].get_int());
+		}
+
+		return thread_count;
+	}
+
 	Db Mongo::get_db(const std::string& database_name) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		return Db(_client[database_name]);
+#ifdef HAS_FEATURE_MONGOCXX
+		std::shared_ptr<mongocxx::client> client = acquire_client();
+
+		return Db(client, (*client)[database_name]);
 #else
 		return Db();
 #endif
@@ -84,8 +137,10 @@ namespace Vortex::Core::Storage::Mongo {
 	}
 
 	Collection Mongo::get_collection(const std::string& database_name, const std::string& collection_name) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		return Collection(_client[database_name][collection_name]);
+#ifdef HAS_FEATURE_MONGOCXX
+		std::shared_ptr<mongocxx::client> client = acquire_client();
+
+		return Collection(client, (*client)[database_name][collection_name]);
 #else
 		return Collection();
 #endif
@@ -94,8 +149,8 @@ namespace Vortex::Core::Storage::Mongo {
 	std::vector<std::string> Mongo::list_databases() {
 		std::vector<std::string> databases;
 
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		auto dbs = _client.list_databases();
+#ifdef HAS_FEATURE_MONGOCXX
+		auto dbs = acquire_client()->list_databases();
 		for (auto it = dbs.begin(); it != dbs.end(); it++) {
 			databases.push_back((*it)["name"].get_utf8().value.to_string());
 		}
@@ -121,8 +176,8 @@ namespace Vortex::Core::Storage::Mongo {
 	}
 
 	bool Mongo::collection_exists(const std::string& database, const std::string& collection) {
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		return _client[database].has_collection(collection);
+#ifdef HAS_FEATURE_MONGOCXX
+		return (*acquire_client())[database].has_collection(collection);
 #else
 		return false;
 #endif
@@ -152,8 +207,138 @@ namespace Vortex::Core::Storage::Mongo {
 		}
 	}
 
+	void Mongo::watch(const CollectionChangedHandler& handler) {
+		if (_watching) {
+			return;
+		}
+
+		_watching = true;
+
+#ifdef HAS_FEATURE_MONGOCXX
+		_watch_thread = std::thread([this, handler]() {
+			// Events after the last handled one are replayed when the stream is reopened
+			bsoncxx::stdx::optional<bsoncxx::document::value> resume_token;
+			int backoff_ms = 0;
+
+			while (_watching) {
+				if (backoff_ms > 0) {
+					const auto retry_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoff_ms);
+
+					while (_watching && std::chrono::steady_clock::now() < retry_at) {
+						std::this_thread::sleep_for(std::chrono::milliseconds(100));
+					}
+
+					if (!_watching) {
+						break;
+					}
+				}
+
+				try {
+					mongocxx::client watch_client{ mongocxx::uri{ get_connection_uri() } };
+
+					mongocxx::options::change_stream options;
+					options.max_await_time(std::chrono::milliseconds(1000));
+					if (resume_token) {
+						options.resume_after(resume_token->view());
+					}
+
+					mongocxx::change_stream stream = watch_client.watch(options);
+
+					while (_watching) {
+						for (const auto& event : stream) {
+							auto ns = event["ns"];
+							auto operation = event["operationType"];
+							const std::string operation_type = operation ? operation.get_utf8().value.to_string() : "";
+
+							// Renamed collections are reported as a drop of the old name and a change of the new one
+							const ChangeType change = (operation_type == "drop" || operation_type == "dropDatabase" || operation_type == "rename") ?
+								ChangeType::Dropped : ChangeType::Modified;
+
+							if (ns && ns.type() == bsoncxx::type::k_document) {
+								auto db = ns["db"];
+								auto coll = ns["coll"];
+
+								handler(
+									db ? db.get_utf8().value.to_string() : "",
+									coll ? coll.get_utf8().value.to_string() : "",
+									change);
+							}
+
+							auto to = event["to"];
+							if (operation_type == "rename" && to && to.type() == bsoncxx::type::k_document) {
+								auto db = to["db"];
+								auto coll = to["coll"];
+
+								handler(
+									db ? db.get_utf8().value.to_string() : "",
+									coll ? coll.get_utf8().value.to_string() : "",
+									ChangeType::Modified);
+							}
+
+							backoff_ms = 0;
+						}
+
+						auto token = stream.get_resume_token();
+						if (token) {
+							resume_token = bsoncxx::document::value(*token);
+						}
+					}
+				}
+				catch (const mongocxx::operation_exception& e) {
+					// The oplog no longer contains the resume point (ChangeStreamHistoryLost)
+					if (resume_token && e.code().value() == 286) {
+						VORTEX_WARN("Mongo change stream can not be resumed, changes made while disconnected are lost - {0}", e.what());
+						resume_token = bsoncxx::stdx::nullopt;
+					}
+					else {
+						VORTEX_ERROR("Mongo change stream closed - {0}", e.what());
+					}
+
+					backoff_ms = std::min(std::max(backoff_ms * 2, 1000), 30000);
+				}
+				catch (const mongocxx::exception& e) {
+					VORTEX_ERROR("Mongo change stream closed - {0}", e.what());
+
+					backoff_ms = std::min(std::max(backoff_ms * 2, 1000), 30000);
+				}
+			}
+			});
+#else
+		VORTEX_WARN("Mongo change streams are unavailable.");
+		_watching = false;
+#endif
+	}
+
+	void Mongo::stop_watching() {
+		_watching = false;
+
+		if (_watch_thread.joinable()) {
+			_watch_thread.join();
+		}
+	}
+
 	const bool Mongo::is_enabled() const {
 		return _enabled;
 	}
 
+#ifdef HAS_FEATURE_MONGOCXX
+	std::shared_ptr<mongocxx::client> Mongo::acquire_client() {
+		mongocxx::pool* pool = nullptr;
+
+		{
+			// The pool is never replaced once created, so it can be used after the lock is released
+			std::lock_guard<std::mutex> lock(_pool_mtx);
+			pool = _pool.get();
+		}
+
+		if (pool == nullptr) {
+			throw Exceptions::StorageException("Mongo is not connected");
+		}
+
+		// The client goes back to the pool once the last Db, Collection or cursor using it is gone.
+		// Waits up to pool.wait_timeout_ms when all clients are in use.
+		return std::shared_ptr<mongocxx::client>(pool->acquire());
+	}
+#endif
+
 }
@@ -2,12 +2,18 @@
 
 #include <string>
 #include <vector>
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#ifdef HAS_FEATURE_MONGOCXX
 #include <mongocxx/client.hpp>
+#include <mongocxx/pool.hpp>
 #endif
 #include <Maze/Maze.hpp>
 #include <Core/Storage/Mongo/Db.h>
 #include <Core/Storage/Mongo/Collection.h>
+#include <Core/Storage/ChangeFeed.h>
 
 namespace Vortex::Core::Storage::Mongo {
 
@@ -15,12 +21,16 @@ namespace Vortex::Core::Storage::Mongo {
 	public:
 		VORTEX_CORE_API Mongo();
 		VORTEX_CORE_API Mongo(const Maze::Element& mongo_config);
+		VORTEX_CORE_API ~Mongo();
 
+		// Creates the connection pool, operations acquire a client from it for their duration
 		VORTEX_CORE_API void connect();
 		VORTEX_CORE_API void set_config(const Maze::Element& mongo_config);
 
 		VORTEX_CORE_API std::string get_connection_uri();
 		VORTEX_CORE_API std::string get_default_db_name();
+		// Threads of the async operations executor, never more than the clients in the pool
+		VORTEX_CORE_API int get_executor_thread_count();
 
 		VORTEX_CORE_API Db get_db(const std::string& database_name);
 		VORTEX_CORE_API Collection get_collection(const std::string& collection_name);
@@ -35,14 +45,24 @@ namespace Vortex::Core::Storage::Mongo {
 		VORTEX_CORE_API void drop_database(const std::string& database_name);
 		VORTEX_CORE_API void clone_database(const std::string& old_name, const std::string& new_name);
 
+		// Watches change streams on a separate connection. Requires mongod to run as a replica set.
+		VORTEX_CORE_API void watch(const CollectionChangedHandler& handler);
+		VORTEX_CORE_API void stop_watching();
+
 		VORTEX_CORE_API const bool is_enabled() const;
 
 	private:
-#ifdef VORTEX_HAS_FEATURE_MONGO
-		mongocxx::client _client;
+#ifdef HAS_FEATURE_MONGOCXX
+		// mongocxx clients must not be shared between threads, every operation uses its own from the pool
+		std::unique_ptr<mongocxx::pool> _pool;
+		std::mutex _pool_mtx;
+
+		std::shared_ptr<mongocxx::client> acquire_client();
 #endif
 		Maze::Element _mongo_config;
 		bool _enabled = true;
+		std::thread _watch_thread;
+		std::atomic<bool> _watching{ false };
 	};
 
 }  // namespace Vortex::Core::Storage::Mongo
@@ -1,13 +1,22 @@
 #include <Core/Storage/Mongo/MongoBackend.h>
+#include <Core/GlobalRuntime.h>
 
 namespace Vortex::Core::Storage::Mongo {
 
     MongoBackend::MongoBackend() {}
 
-    MongoBackend::~MongoBackend() {}
+    MongoBackend::~MongoBackend() {
+        if (_executor) {
+            _executor->join();
+        }
+
+        _metadata.stop();
+    }
 
     void MongoBackend::simple_insert(const std::string& database, const std::string& collection, const std::string& json_value) {
         _client.get_collection(database, collection).insert_one(json_value);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
     }
 
     const std::string MongoBackend::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
@@ -20,36 +29,116 @@ namespace Vortex::Core::Storage::Mongo {
 
     void MongoBackend::simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) {
         _client.get_collection(database, collection).replace_one(json_simple_query, replacement_json_value);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
     }
 
     void MongoBackend::simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
         _client.get_collection(database, collection).delete_many(json_simple_query);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
     }
 
     void MongoBackend::simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
         _client.get_collection(database, collection).delete_one(json_simple_query);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
+    }
+
+    void MongoBackend::insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) {
+        _client.get_collection(database, collection).insert_one(value);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
+    }
+
+    Maze::Element MongoBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return _client.get_collection(database, collection).find(simple_query);
+    }
+
+    Maze::Element MongoBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return _client.get_collection(database, collection).find_one(simple_query);
+    }
+
+    void MongoBackend::replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) {
+        _client.get_collection(database, collection).replace_one(simple_query, replacement_value);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
+    }
+
+    void MongoBackend::delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        _client.get_collection(database, collection).delete_many(simple_query);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
+    }
+
+    void MongoBackend::delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        _client.get_collection(database, collection).delete_one(simple_query);
+
+        GlobalRuntime::instance().storage().change_feed().publish(database, collection);
+    }
+
+    Maze::Element MongoBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        return _client.get_collection(database, collection).find(simple_query, projection);
+    }
+
+    Maze::Element MongoBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        return _client.get_collection(database, collection).find_one(simple_query, projection);
+    }
+
+    std::unique_ptr<StorageCursor> MongoBackend::find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) {
+        return _client.get_collection(database, collection).find(simple_query, options);
     }
 
     const std::vector<std::string> MongoBackend::get_database_list() {
+        if (_metadata.is_loaded()) {
+            return _metadata.get_database_list();
+        }
+
         return _client.list_databases();
     }
 
     const std::vector<std::string> MongoBackend::get_collection_list(const std::string& database) {
+        if (_metadata.is_loaded()) {
+            return _metadata.get_collection_list(database);
+        }
+
         return _client.list_collections(database);
     }
 
     bool MongoBackend::database_exists(const std::string& database) {
-        return false;
+        if (_metadata.is_loaded()) {
+            return _metadata.database_exists(database);
+        }
+
+        return _client.database_exists(database);
     }
 
     bool MongoBackend::collection_exists(const std::string& database, const std::string& collection) {
-        return false;
+        if (_metadata.is_loaded()) {
+            return _metadata.collection_exists(database, collection);
+        }
+
+        return _client.collection_exists(database, collection);
+    }
+
+    boost::asio::thread_pool& MongoBackend::blocking_pool() {
+        std::lock_guard<std::mutex> lock(_executor_mtx);
+
+        if (!_executor) {
+            _executor = std::make_unique<boost::asio::thread_pool>(_client.get_executor_thread_count());
+        }
+
+        return *_executor;
     }
 
     Core::Storage::Mongo::Mongo* MongoBackend::get_client() {
         return &_client;
     }
 
+    MongoMetadata* MongoBackend::get_metadata() {
+        return &_metadata;
+    }
+
     StorageBackendInterface* get_mongo_backend() {
         static MongoBackend instance;
         return &instance;
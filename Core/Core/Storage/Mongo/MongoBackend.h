@@ -1,14 +1,21 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <Core/Storage/Storage.h>
 #include <Core/Storage/Mongo/Mongo.h>
+#include <Core/Storage/Mongo/MongoMetadata.h>
 
 namespace Vortex::Core::Storage::Mongo {
 
 	class MongoBackend : public StorageBackendInterface {
 	private:
 		Core::Storage::Mongo::Mongo _client;
+		// Database and collection names for existence checks without a round trip to the server
+		MongoMetadata _metadata;
+		std::unique_ptr<boost::asio::thread_pool> _executor;
+		std::mutex _executor_mtx;
 
 	public:
 		MongoBackend();
@@ -22,13 +29,31 @@ namespace Vortex::Core::Storage::Mongo {
 		virtual void simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
 		virtual void simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
 
+		// Structured query, documents are converted to and from bson directly
+		virtual void insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) override;
+		virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+		virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+		virtual void replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) override;
+		virtual void delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+		virtual void delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+
+		// Projection is sent to the server, unselected fields are never transferred
+		virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+		virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+
+		virtual std::unique_ptr<StorageCursor> find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) override;
+
 		virtual const std::vector<std::string> get_database_list() override;
 		virtual const std::vector<std::string> get_collection_list(const std::string& database) override;
 
 		virtual bool database_exists(const std::string& database) override;
 		virtual bool collection_exists(const std::string& database, const std::string& collection) override;
 
+		// Async operations run on as many threads as there are pooled clients for them
+		virtual boost::asio::thread_pool& blocking_pool() override;
+
 		Core::Storage::Mongo::Mongo* get_client();
+		MongoMetadata* get_metadata();
 	};
 
 
@@ -0,0 +1,182 @@
+#include <Core/Storage/Mongo/MongoMetadata.h>
+#include <Core/Storage/Mongo/Mongo.h>
+#include <Core/Logging.h>
+
+namespace Vortex::Core::Storage::Mongo {
+
+	MongoMetadata::MongoMetadata() {}
+
+	MongoMetadata::~MongoMetadata() {
+		stop();
+	}
+
+	void MongoMetadata::start(Mongo* client, ChangeFeed& change_feed, int refresh_interval) {
+		if (_running.exchange(true)) {
+			return;
+		}
+
+		_client = client;
+		_change_feed = &change_feed;
+
+		if (refresh_interval > 0) {
+			_refresh_interval = refresh_interval;
+		}
+
+		// Existence checks are answered from the first load on
+		refresh();
+
+		_subscription_id = _change_feed->subscribe([this](const std::string& database, const std::string& collection, ChangeType change) {
+			on_collection_changed(database, collection, change);
+			});
+
+		_thread = std::thread(&MongoMetadata::run, this);
+	}
+
+	void MongoMetadata::stop() {
+		if (!_running) {
+			return;
+		}
+
+		if (_change_feed != nullptr) {
+			_change_feed->unsubscribe(_subscription_id);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_thread_mtx);
+			_running = false;
+		}
+		_cv.notify_all();
+
+		if (_thread.joinable()) {
+			_thread.join();
+		}
+	}
+
+	void MongoMetadata::refresh() {
+		if (_client == nullptr) {
+			return;
+		}
+
+		std::unordered_map<std::string, std::unordered_set<std::string>> databases;
+
+		// Names are listed without holding the lock, lookups keep using the previous state meanwhile
+		try {
+			for (const auto& database : _client->list_databases()) {
+				std::unordered_set<std::string>& collections = databases[database];
+
+				for (const auto& collection : _client->list_collections(database)) {
+					collections.insert(collection);
+				}
+			}
+		}
+		catch (const std::exception& e) {
+			VORTEX_ERROR("Unable to load Mongo metadata - {0}", e.what());
+			return;
+		}
+
+		std::unique_lock<std::shared_mutex> lock(_mtx);
+		_databases.swap(databases);
+		_loaded = true;
+	}
+
+	const bool MongoMetadata::is_loaded() const {
+		return _loaded;
+	}
+
+	bool MongoMetadata::database_exists(const std::string& database) const {
+		std::shared_lock<std::shared_mutex> lock(_mtx);
+
+		return _databases.find(database) != _databases.end();
+	}
+
+	bool MongoMetadata::collection_exists(const std::string& database, const std::string& collection) const {
+		std::shared_lock<std::shared_mutex> lock(_mtx);
+
+		const auto& it = _databases.find(database);
+
+		return it != _databases.end() && it->second.find(collection) != it->second.end();
+	}
+
+	const std::vector<std::string> MongoMetadata::get_database_list() const {
+		std::shared_lock<std::shared_mutex> lock(_mtx);
+		std::vector<std::string> databases;
+
+		for (const auto& database : _databases) {
+			databases.push_back(database.first);
+		}
+
+		return databases;
+	}
+
+	const std::vector<std::string> MongoMetadata::get_collection_list(const std::string& database) const {
+		std::shared_lock<std::shared_mutex> lock(_mtx);
+		std::vector<std::string> collections;
+
+		const auto& it = _databases.find(database);
+		if (it != _databases.end()) {
+			collections.assign(it->second.begin(), it->second.end());
+		}
+
+		return collections;
+	}
+
+	void MongoMetadata::on_collection_changed(const std::string& database, const std::string& collection, ChangeType change) {
+		if (change == ChangeType::Dropped) {
+			std::unique_lock<std::shared_mutex> lock(_mtx);
+
+			if (collection.empty()) {
+				_databases.erase(database);
+
+				return;
+			}
+
+			const auto& it = _databases.find(database);
+			if (it != _databases.end()) {
+				it->second.erase(collection);
+			}
+
+			return;
+		}
+
+		// Other whole database changes can't be applied from the event alone
+		if (collection.empty()) {
+			std::lock_guard<std::mutex> lock(_thread_mtx);
+			_refresh_requested = true;
+			_cv.notify_all();
+
+			return;
+		}
+
+		{
+			std::shared_lock<std::shared_mutex> lock(_mtx);
+
+			const auto& it = _databases.find(database);
+			if (it != _databases.end() && it->second.find(collection) != it->second.end()) {
+				return;
+			}
+		}
+
+		// Writes create databases and collections
+		std::unique_lock<std::shared_mutex> lock(_mtx);
+		_databases[database].insert(collection);
+	}
+
+	void MongoMetadata::run() {
+		std::unique_lock<std::mutex> lock(_thread_mtx);
+
+		while (_running) {
+			_cv.wait_for(lock, std::chrono::seconds(_refresh_interval), [this]() { return !_running || _refresh_requested; });
+
+			if (!_running) {
+				break;
+			}
+
+			_refresh_requested = false;
+
+			lock.unlock();
+			refresh();
+			lock.lock();
+		}
+	}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <Core/Storage/ChangeFeed.h>
+
+namespace Vortex::Core::Storage::Mongo {
+
+	class Mongo;
+
+
+	// Database and collection names of the Mongo server, so existence checks are a hash lookup.
+	// Reloaded every refresh_interval seconds, names reported by the change feed are added or removed immediately.
+	class MongoMetadata {
+	public:
+		MongoMetadata();
+		~MongoMetadata();
+
+		void start(Mongo* client, ChangeFeed& change_feed, int refresh_interval);
+		void stop();
+		void refresh();
+
+		const bool is_loaded() const;
+		bool database_exists(const std::string& database) const;
+		bool collection_exists(const std::string& database, const std::string& collection) const;
+		const std::vector<std::string> get_database_list() const;
+		const std::vector<std::string> get_collection_list(const std::string& database) const;
+
+	private:
+		Mongo* _client = nullptr;
+		// Collection names of every database
+		std::unordered_map<std::string, std::unordered_set<std::string>> _databases;
+		mutable std::shared_mutex _mtx;
+		std::atomic<bool> _loaded{ false };
+
+		int _refresh_interval = 30;
+		ChangeFeed* _change_feed = nullptr;
+		int _subscription_id = 0;
+		std::thread _thread;
+		std::atomic<bool> _running{ false };
+		bool _refresh_requested = false;
+		std::mutex _thread_mtx;
+		std::condition_variable _cv;
+
+		void on_collection_changed(const std::string& database, const std::string& collection, ChangeType change);
+		void run();
+	};
+
+}  // namespace Vortex::Core::Storage::Mongo
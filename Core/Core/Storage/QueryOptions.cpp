@@ -0,0 +1,277 @@
+#include <Core/Storage/QueryOptions.h>
+#include <Core/Util/String.h>
+
+namespace Vortex::Core::Storage {
+
+    namespace {
+
+        bool is_truthy(const Maze::Element& value) {
+            if (value.is_int()) {
+                return value.get_int() != 0;
+            }
+            else if (value.is_double()) {
+                return value.get_double() != 0;
+            }
+            else if (value.is_bool()) {
+                return value.get_bool();
+            }
+
+            return !value.is_null();
+        }
+
+        // Ordering of values with different types, similar to the one used by mongo
+        int type_rank(const Maze::Element& value) {
+            switch (value.get_type()) {
+            case Maze::Type::Null:
+                return 0;
+            case Maze::Type::Int:
+            case Maze::Type::Double:
+                return 1;
+            case Maze::Type::String:
+                return 2;
+            case Maze::Type::Object:
+                return 3;
+            case Maze::Type::Array:
+                return 4;
+            case Maze::Type::Bool:
+                return 5;
+            }
+
+            return 0;
+        }
+
+        double get_number(const Maze::Element& value) {
+            return value.is_int() ? (double)value.get_int() : value.get_double();
+        }
+
+        void set_field(Maze::Element& document, const std::string& field, const Maze::Element& value) {
+            const std::vector<std::string> parts = Util::String::split(field, ".");
+            Maze::Element* current = &document;
+
+            for (size_t i = 0; i + 1 < parts.size(); ++i) {
+                if (!current->is_object(parts[i])) {
+                    current->set(parts[i], Maze::Element(Maze::Type::Object));
+                }
+
+                current = &(*current)[parts[i]];
+            }
+
+            current->set(parts.back(), value);
+        }
+
+        void remove_field(Maze::Element& document, const std::string& field) {
+            const std::vector<std::string> parts = Util::String::split(field, ".");
+            Maze::Element* current = &document;
+
+            for (size_t i = 0; i + 1 < parts.size(); ++i) {
+                if (!current->is_object(parts[i])) {
+                    return;
+                }
+
+                current = &(*current)[parts[i]];
+            }
+
+            if (current->exists(parts.back())) {
+                current->remove(parts.back());
+            }
+        }
+
+    }  // namespace
+
+    QueryOptions QueryOptions::from_element(const Maze::Element& options) {
+        QueryOptions result;
+
+        if (options.is_int("limit") && options["limit"].get_int() > 0) {
+            result.limit = options["limit"].get_int();
+        }
+
+        if (options.is_int("skip") && options["skip"].get_int() > 0) {
+            result.skip = options["skip"].get_int();
+        }
+
+        if (options.is_object("sort")) {
+            result.sort = options["sort"];
+        }
+
+        if (options.is_object("projection")) {
+            result.projection = options["projection"];
+        }
+
+        if (options.is_int("batch_size") && options["batch_size"].get_int() > 0) {
+            result.batch_size = options["batch_size"].get_int();
+        }
+
+        if (options.is_object("after")) {
+            result.after = options["after"];
+        }
+
+        return result;
+    }
+
+    Maze::Element QueryOptions::to_element() const {
+        return Maze::Element(
+            { "limit", "skip", "sort", "projection", "batch_size", "after" },
+            { Maze::Element(limit), Maze::Element(skip), sort, projection, Maze::Element(batch_size), after });
+    }
+
+    std::vector<std::pair<std::string, int>> QueryOptions::keyset_fields() const {
+        std::vector<std::pair<std::string, int>> fields;
+
+        const Maze::Element& order = sort.has_children() ? sort : after;
+
+        for (auto it = order.keys_begin(); it != order.keys_end(); ++it) {
+            const Maze::Element& direction = order[*it];
+            const bool descending = sort.has_children() && (direction.is_int() || direction.is_double()) && get_number(direction) < 0;
+
+            fields.push_back(std::make_pair(*it, descending ? -1 : 1));
+        }
+
+        // Without a unique last field, pages would skip the documents which tie with the last returned one
+        if (!fields.empty() && !order.exists("_id")) {
+            fields.push_back(std::make_pair(std::string("_id"), 1));
+        }
+
+        return fields;
+    }
+
+    Maze::Element QueryOptions::keyset(const Maze::Element& document) const {
+        Maze::Element result(Maze::Type::Object);
+
+        for (const auto& field : keyset_fields()) {
+            set_field(result, field.first, get_field(document, field.first));
+        }
+
+        return result;
+    }
+
+    int QueryOptions::compare(const Maze::Element& a, const Maze::Element& b) const {
+        return compare(a, b, keyset_fields());
+    }
+
+    int QueryOptions::compare(const Maze::Element& a, const Maze::Element& b, const std::vector<std::pair<std::string, int>>& fields) {
+        for (const auto& field : fields) {
+            int result = compare_values(get_field(a, field.first), get_field(b, field.first));
+
+            if (result != 0) {
+                return result * field.second;
+            }
+        }
+
+        return 0;
+    }
+
+    bool QueryOptions::is_after(const Maze::Element& document) const {
+        if (!after.has_children()) {
+            return true;
+        }
+
+        // Lexicographic comparison of the keyset, like (a, b) > (x, y)
+        return compare(document, after, keyset_fields()) > 0;
+    }
+
+    bool QueryOptions::is_inclusion_projection() const {
+        for (auto it = projection.keys_begin(); it != projection.keys_end(); ++it) {
+            if (*it != "_id" && is_truthy(projection[*it])) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Maze::Element QueryOptions::project(const Maze::Element& document) const {
+        if (!projection.has_children() || !document.is_object()) {
+            return document;
+        }
+
+        if (!is_inclusion_projection()) {
+            Maze::Element result = document;
+
+            for (auto it = projection.keys_begin(); it != projection.keys_end(); ++it) {
+                remove_field(result, *it);
+            }
+
+            return result;
+        }
+
+        Maze::Element result(Maze::Type::Object);
+
+        // _id is included unless it is excluded explicitly
+        if (document.exists("_id") && !(projection.exists("_id") && !is_truthy(projection["_id"]))) {
+            result.set("_id", document["_id"]);
+        }
+
+        for (auto it = projection.keys_begin(); it != projection.keys_end(); ++it) {
+            if (*it == "_id" || !is_truthy(projection[*it])) {
+                continue;
+            }
+
+            const Maze::Element* value = &get_field(document, *it);
+            if (value != &Maze::Element::get_null_element()) {
+                set_field(result, *it, *value);
+            }
+        }
+
+        return result;
+    }
+
+    QueryOptions QueryOptions::next_page(const Maze::Element& last_keyset, int returned_count) const {
+        QueryOptions next = *this;
+
+        if (limit > 0) {
+            next.limit = limit - returned_count;
+        }
+
+        if (sort.has_children() || after.has_children()) {
+            next.after = last_keyset;
+            next.skip = 0;
+        }
+        else {
+            next.skip = skip + returned_count;
+        }
+
+        return next;
+    }
+
+    const Maze::Element& QueryOptions::get_field(const Maze::Element& document, const std::string& field) {
+        const Maze::Element* current = &document;
+
+        for (const auto& part : Util::String::split(field, ".")) {
+            if (!current->is_object() || !current->exists(part)) {
+                return Maze::Element::get_null_element();
+            }
+
+            current = &(*current)[part];
+        }
+
+        return *current;
+    }
+
+    int QueryOptions::compare_values(const Maze::Element& a, const Maze::Element& b) {
+        const int rank_a = type_rank(a);
+        const int rank_b = type_rank(b);
+
+        if (rank_a != rank_b) {
+            return rank_a < rank_b ? -1 : 1;
+        }
+
+        switch (rank_a) {
+        case 1: {
+            const double number_a = get_number(a);
+            const double number_b = get_number(b);
+
+            return number_a < number_b ? -1 : (number_a > number_b ? 1 : 0);
+        }
+        case 2:
+            return a.get_string().compare(b.get_string());
+        case 3:
+        case 4:
+            return a.to_json(0).compare(b.to_json(0));
+        case 5:
+            return (int)a.get_bool() - (int)b.get_bool();
+        }
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Storage {
+
+    struct QueryOptions {
+        // 0 means no limit
+        int limit = 0;
+        int skip = 0;
+        // { "field": 1 | -1, ... }, fields can be dotted paths
+        Maze::Element sort = Maze::Element(Maze::Type::Object);
+        // { "field": 1, ... } to include or { "field": 0, ... } to exclude fields
+        Maze::Element projection = Maze::Element(Maze::Type::Object);
+        int batch_size = 100;
+        // Keyset pagination: only documents ordered after these sort field values are returned
+        Maze::Element after = Maze::Element(Maze::Type::Object);
+
+        VORTEX_CORE_API static QueryOptions from_element(const Maze::Element& options);
+        VORTEX_CORE_API Maze::Element to_element() const;
+
+        // Sort fields with their direction, the fields of after in ascending order if no sort is set.
+        // _id is appended as the last field so documents sharing the sort values still have a strict order.
+        VORTEX_CORE_API std::vector<std::pair<std::string, int>> keyset_fields() const;
+        VORTEX_CORE_API Maze::Element keyset(const Maze::Element& document) const;
+        // Negative, zero or positive like strcmp, in the order of the keyset fields
+        VORTEX_CORE_API int compare(const Maze::Element& a, const Maze::Element& b) const;
+        VORTEX_CORE_API static int compare(const Maze::Element& a, const Maze::Element& b, const std::vector<std::pair<std::string, int>>& fields);
+        VORTEX_CORE_API bool is_after(const Maze::Element& document) const;
+        // Projection lists the fields to keep instead of the ones to remove
+        VORTEX_CORE_API bool is_inclusion_projection() const;
+        VORTEX_CORE_API Maze::Element project(const Maze::Element& document) const;
+
+        // Options which continue right after the last returned document
+        VORTEX_CORE_API QueryOptions next_page(const Maze::Element& last_keyset, int returned_count) const;
+
+        VORTEX_CORE_API static const Maze::Element& get_field(const Maze::Element& document, const std::string& field);
+        VORTEX_CORE_API static int compare_values(const Maze::Element& a, const Maze::Element& b);
+    };
+
+}  // namespace Vortex::Core::Storage
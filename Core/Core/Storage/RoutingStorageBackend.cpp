@@ -0,0 +1,225 @@
+#include <Core/Storage/RoutingStorageBackend.h>
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <Core/Exceptions/StorageException.h>
+
+namespace Vortex::Core::Storage {
+
+    RoutingStorageBackend::RoutingStorageBackend(const Maze::Element& routes_config,
+        const std::vector<std::pair<std::string, StorageBackendInterface*>>& backends, StorageBackendInterface* default_backend)
+        : _default_backend(default_backend) {
+        for (int i = 0; i < routes_config.count_children(); ++i) {
+            const Maze::Element& route_config = routes_config[i];
+
+            if (!route_config.is_string("backend")) {
+                throw Exceptions::StorageException("Storage route " + std::to_string(i) + " has no backend");
+            }
+
+            const std::string backend_name = route_config["backend"].get_string();
+            auto backend = std::find_if(backends.begin(), backends.end(), [&backend_name](const std::pair<std::string, StorageBackendInterface*>& b) {
+                return b.first == backend_name;
+                });
+
+            if (backend == backends.end()) {
+                throw Exceptions::StorageException("Storage backend " + backend_name + " requested in routes is not available");
+            }
+
+            StorageRoute route;
+            route.database = route_config.is_string("database") ? route_config["database"].get_string() : "*";
+            route.collection = route_config.is_string("collection") ? route_config["collection"].get_string() : "*";
+            route.backend = backend->second;
+            _routes.push_back(route);
+
+            if (std::find(_backends.begin(), _backends.end(), route.backend) == _backends.end()) {
+                _backends.push_back(route.backend);
+            }
+        }
+
+        _backends.erase(std::remove(_backends.begin(), _backends.end(), _default_backend), _backends.end());
+        _backends.push_back(_default_backend);
+    }
+
+    void RoutingStorageBackend::simple_insert(const std::string& database, const std::string& collection, const std::string& json_value) {
+        route(database, collection)->simple_insert(database, collection, json_value);
+    }
+
+    const std::string RoutingStorageBackend::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        return route(database, collection)->simple_find_all(database, collection, json_simple_query);
+    }
+
+    const std::string RoutingStorageBackend::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        return route(database, collection)->simple_find_first(database, collection, json_simple_query);
+    }
+
+    void RoutingStorageBackend::simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) {
+        route(database, collection)->simple_replace_first(database, collection, json_simple_query, replacement_json_value);
+    }
+
+    void RoutingStorageBackend::simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        route(database, collection)->simple_delete_all(database, collection, json_simple_query);
+    }
+
+    void RoutingStorageBackend::simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) {
+        route(database, collection)->simple_delete_first(database, collection, json_simple_query);
+    }
+
+    void RoutingStorageBackend::insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) {
+        route(database, collection)->insert_document(database, collection, value);
+    }
+
+    Maze::Element RoutingStorageBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return route(database, collection)->find_all_documents(database, collection, simple_query);
+    }
+
+    Maze::Element RoutingStorageBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return route(database, collection)->find_first_document(database, collection, simple_query);
+    }
+
+    void RoutingStorageBackend::replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) {
+        route(database, collection)->replace_first_document(database, collection, simple_query, replacement_value);
+    }
+
+    void RoutingStorageBackend::delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        route(database, collection)->delete_all_documents(database, collection, simple_query);
+    }
+
+    void RoutingStorageBackend::delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        route(database, collection)->delete_first_document(database, collection, simple_query);
+    }
+
+    const std::string RoutingStorageBackend::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) {
+        return route(database, collection)->simple_find_all(database, collection, json_simple_query, json_projection);
+    }
+
+    const std::string RoutingStorageBackend::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) {
+        return route(database, collection)->simple_find_first(database, collection, json_simple_query, json_projection);
+    }
+
+    Maze::Element RoutingStorageBackend::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        return route(database, collection)->find_all_documents(database, collection, simple_query, projection);
+    }
+
+    Maze::Element RoutingStorageBackend::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        return route(database, collection)->find_first_document(database, collection, simple_query, projection);
+    }
+
+    std::unique_ptr<StorageCursor> RoutingStorageBackend::find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) {
+        return route(database, collection)->find_documents(database, collection, simple_query, options);
+    }
+
+    const std::vector<std::string> RoutingStorageBackend::get_database_list() {
+        std::set<std::string> databases;
+
+        for (auto backend : _backends) {
+            for (const auto& database : backend->get_database_list()) {
+                databases.insert(database);
+            }
+        }
+
+        return std::vector<std::string>(databases.begin(), databases.end());
+    }
+
+    const std::vector<std::string> RoutingStorageBackend::get_collection_list(const std::string& database) {
+        std::set<std::string> collections;
+
+        for (auto backend : _backends) {
+            for (const auto& collection : backend->get_collection_list(database)) {
+                if (route(database, collection) == backend) {
+                    collections.insert(collection);
+                }
+            }
+        }
+
+        return std::vector<std::string>(collections.begin(), collections.end());
+    }
+
+    bool RoutingStorageBackend::database_exists(const std::string& database) {
+        for (auto backend : _backends) {
+            if (backend->database_exists(database)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool RoutingStorageBackend::collection_exists(const std::string& database, const std::string& collection) {
+        return route(database, collection)->collection_exists(database, collection);
+    }
+
+    boost::asio::thread_pool& RoutingStorageBackend::blocking_pool() {
+        return _default_backend->blocking_pool();
+    }
+
+    boost::asio::thread_pool& RoutingStorageBackend::blocking_pool_for(const std::string& database, const std::string& collection) {
+        return route(database, collection)->blocking_pool_for(database, collection);
+    }
+
+    StorageBackendInterface* RoutingStorageBackend::route(const std::string& database, const std::string& collection) {
+        // Database names can't contain a slash on any backend
+        const std::string key = database + "/" + collection;
+
+        {
+            std::shared_lock<std::shared_mutex> lock(_resolved_mtx);
+
+            auto it = _resolved.find(key);
+            if (it != _resolved.end()) {
+                return it->second;
+            }
+        }
+
+        StorageBackendInterface* backend = _default_backend;
+
+        for (const auto& route : _routes) {
+            if (matches_pattern(route.database, database) && matches_pattern(route.collection, collection)) {
+                backend = route.backend;
+                break;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_resolved_mtx);
+
+        // Names come from requests, so the memo can't grow with every name that was ever asked for
+        if (_resolved.size() >= max_resolved) {
+            _resolved.clear();
+        }
+
+        _resolved[key] = backend;
+
+        return backend;
+    }
+
+    bool RoutingStorageBackend::matches_pattern(const std::string& pattern, const std::string& value) {
+        size_t p = 0;
+        size_t v = 0;
+        size_t star = std::string::npos;
+        size_t star_value = 0;
+
+        while (v < value.length()) {
+            if (p < pattern.length() && pattern[p] == '*') {
+                star = p++;
+                star_value = v;
+            }
+            else if (p < pattern.length() && pattern[p] == value[v]) {
+                ++p;
+                ++v;
+            }
+            else if (star != std::string::npos) {
+                // Let the last * match one more character
+                p = star + 1;
+                v = ++star_value;
+            }
+            else {
+                return false;
+            }
+        }
+
+        while (p < pattern.length() && pattern[p] == '*') {
+            ++p;
+        }
+
+        return p == pattern.length();
+    }
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+#include <Core/Storage/Storage.h>
+
+namespace Vortex::Core::Storage {
+
+    struct StorageRoute {
+        // Patterns where * matches any sequence of characters
+        std::string database;
+        std::string collection;
+        StorageBackendInterface* backend;
+    };
+
+
+    // Dispatches every call to the backend of the first route matching the database and collection, or to the default backend.
+    // Resolved backends are memoized per database and collection, so patterns are only matched on first use.
+    // The memo is bounded, it starts over once it holds max_resolved pairs.
+    //
+    // Configured by storage.routes:
+    // [ { "database": "vortex", "collection": "hosts", "backend": "Filesystem" }, { "collection": "*", "backend": "Mongo" } ]
+    class RoutingStorageBackend : public StorageBackendInterface {
+    public:
+        VORTEX_CORE_API RoutingStorageBackend(const Maze::Element& routes_config,
+            const std::vector<std::pair<std::string, StorageBackendInterface*>>& backends, StorageBackendInterface* default_backend);
+
+        // Simple query
+        VORTEX_CORE_API virtual void simple_insert(const std::string& database, const std::string& collection, const std::string& json_value) override;
+        VORTEX_CORE_API virtual const std::string simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+        VORTEX_CORE_API virtual const std::string simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+        VORTEX_CORE_API virtual void simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) override;
+        VORTEX_CORE_API virtual void simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+        VORTEX_CORE_API virtual void simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) override;
+
+        // Structured query
+        VORTEX_CORE_API virtual void insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) override;
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual void replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) override;
+        VORTEX_CORE_API virtual void delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+        VORTEX_CORE_API virtual void delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) override;
+
+        VORTEX_CORE_API virtual const std::string simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) override;
+        VORTEX_CORE_API virtual const std::string simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) override;
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) override;
+
+        VORTEX_CORE_API virtual std::unique_ptr<StorageCursor> find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) override;
+
+        // Lists combine every backend, a collection is only listed by the backend it is routed to
+        VORTEX_CORE_API virtual const std::vector<std::string> get_database_list() override;
+        VORTEX_CORE_API virtual const std::vector<std::string> get_collection_list(const std::string& database) override;
+
+        VORTEX_CORE_API virtual bool database_exists(const std::string& database) override;
+        VORTEX_CORE_API virtual bool collection_exists(const std::string& database, const std::string& collection) override;
+
+        // Async calls run on the pool of the backend the collection is routed to
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool() override;
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool_for(const std::string& database, const std::string& collection) override;
+
+        VORTEX_CORE_API StorageBackendInterface* route(const std::string& database, const std::string& collection);
+
+        VORTEX_CORE_API static bool matches_pattern(const std::string& pattern, const std::string& value);
+
+    private:
+        static const size_t max_resolved = 4096;
+
+        std::vector<StorageRoute> _routes;
+        StorageBackendInterface* _default_backend;
+        // Distinct backends in the order they are first used by a route, the default one last
+        std::vector<StorageBackendInterface*> _backends;
+        std::unordered_map<std::string, StorageBackendInterface*> _resolved;
+        std::shared_mutex _resolved_mtx;
+    };
+
+}  // namespace Vortex::Core::Storage
@@ -1,12 +1,103 @@
 #include <Core/Storage/Storage.h>
+#include <algorithm>
+#include <thread>
+#include <Core/Storage/CachingStorageBackend.h>
+#include <Core/Storage/RoutingStorageBackend.h>
 #include <Core/Storage/Filesystem/FilesystemBackend.h>
 #include <Core/Exceptions/StorageException.h>
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
 #include <Core/Storage/Mongo/MongoBackend.h>
 #endif
 
 namespace Vortex::Core::Storage {
 
+    void StorageBackendInterface::insert_document(const std::string& database, const std::string& collection, const Maze::Element& value) {
+        simple_insert(database, collection, value.to_json(0));
+    }
+
+    Maze::Element StorageBackendInterface::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return Maze::Element::from_json(simple_find_all(database, collection, simple_query.to_json(0)));
+    }
+
+    Maze::Element StorageBackendInterface::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        return Maze::Element::from_json(simple_find_first(database, collection, simple_query.to_json(0)));
+    }
+
+    void StorageBackendInterface::replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value) {
+        simple_replace_first(database, collection, simple_query.to_json(0), replacement_value.to_json(0));
+    }
+
+    void StorageBackendInterface::delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        simple_delete_all(database, collection, simple_query.to_json(0));
+    }
+
+    void StorageBackendInterface::delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query) {
+        simple_delete_first(database, collection, simple_query.to_json(0));
+    }
+
+    const std::string StorageBackendInterface::simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) {
+        return find_all_documents(database, collection, Maze::Element::from_json(json_simple_query), Maze::Element::from_json(json_projection)).to_json();
+    }
+
+    const std::string StorageBackendInterface::simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection) {
+        return find_first_document(database, collection, Maze::Element::from_json(json_simple_query), Maze::Element::from_json(json_projection)).to_json();
+    }
+
+    Maze::Element StorageBackendInterface::find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        QueryOptions options;
+        options.projection = projection;
+
+        Maze::Element documents = find_all_documents(database, collection, simple_query);
+        Maze::Element results(Maze::Type::Array);
+
+        for (int i = 0; i < documents.count_children(); ++i) {
+            results.push_back(options.project(documents[i]));
+        }
+
+        return results;
+    }
+
+    Maze::Element StorageBackendInterface::find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection) {
+        QueryOptions options;
+        options.projection = projection;
+
+        return options.project(find_first_document(database, collection, simple_query));
+    }
+
+    std::unique_ptr<StorageCursor> StorageBackendInterface::find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) {
+        std::shared_ptr<const Maze::Element> documents = std::make_shared<const Maze::Element>(find_all_documents(database, collection, simple_query));
+
+        std::vector<int> positions;
+        for (int i = 0; i < documents->count_children(); ++i) {
+            positions.push_back(i);
+        }
+
+        return std::make_unique<DocumentCursor>(documents, positions, options);
+    }
+
+    Maze::Element StorageBackendInterface::find_page(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options) {
+        std::unique_ptr<StorageCursor> cursor = find_documents(database, collection, simple_query, options);
+
+        Maze::Element documents = cursor->next_batch();
+        Maze::Element next;
+
+        if (documents.count_children() > 0 && cursor->has_more()) {
+            next = options.next_page(cursor->last_keyset(), documents.count_children()).to_element();
+        }
+
+        return Maze::Element({ "documents", "next" }, { documents, next });
+    }
+
+    boost::asio::thread_pool& StorageBackendInterface::blocking_pool() {
+        static boost::asio::thread_pool pool(std::max(4u, std::thread::hardware_concurrency()));
+
+        return pool;
+    }
+
+    boost::asio::thread_pool& StorageBackendInterface::blocking_pool_for(const std::string&, const std::string&) {
+        return blocking_pool();
+    }
+
     void Storage::initialize(const Maze::Element& storage_config) {
         _mtx.lock();
         _storage_config = storage_config;
@@ -20,14 +111,28 @@ namespace Vortex::Core::Storage {
             static_cast<Core::Storage::StorageBackendInterface*>(fs_backend)
             ));
 
-#ifdef VORTEX_HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
                 Mongo::MongoBackend* mongo_backend = static_cast<Core::Storage::Mongo::MongoBackend*>(Core::Storage::Mongo::mongo_exports.get_backend_instance());
                 mongo_backend->get_client()->set_config(storage_config.get("config").get("Mongo"));
 
                 if (mongo_backend->get_client()->is_enabled()) {
                     mongo_backend->get_client()->connect();
 
-                    available_backends_.push_back(std::make_pair<std::string, StorageBackendInterface*>(
+                    if (storage_config.get("config").get("Mongo").is_bool("change_streams") &&
+                        storage_config.get("config").get("Mongo")["change_streams"].get_bool()) {
+                        mongo_backend->get_client()->watch([this](const std::string& database, const std::string& collection, ChangeType change) {
+                            _change_feed.publish(database, collection, change);
+                            });
+                    }
+
+                    int metadata_refresh_interval = 30;
+                    if (storage_config.get("config").get("Mongo").is_int("metadata_refresh_interval")) {
+                        metadata_refresh_interval = storage_config.get("config").get("Mongo")["metadata_refresh_interval"].get_int();
+                    }
+
+                    mongo_backend->get_metadata()->start(mongo_backend->get_client(), _change_feed, metadata_refresh_interval);
+
+                    _available_backends.push_back(std::make_pair<std::string, StorageBackendInterface*>(
                         Core::Storage::Mongo::mongo_exports.backend_name,
                         static_cast<Core::Storage::StorageBackendInterface*>(mongo_backend)
                         ));
@@ -58,6 +163,31 @@ namespace Vortex::Core::Storage {
                     }
                 }
 
+        // Query results of every backend are cached when storage.caching is enabled
+        const Maze::Element& caching_config = storage_config.get_const_ref("caching", Maze::Type::Object);
+        if (caching_config.is_bool("enabled") && caching_config["enabled"].get_bool()) {
+            for (auto& backend : _available_backends) {
+                _decorators.push_back(std::make_unique<CachingStorageBackend>(backend.second, caching_config, _change_feed));
+                backend.second = _decorators.back().get();
+            }
+        }
+
+        // Routes resolve to the (cached) backends above, collections without a route stay in the default backend
+        _router = nullptr;
+        if (storage_config.is_array("routes") && storage_config["routes"].count_children() > 0) {
+            StorageBackendInterface* default_backend = nullptr;
+
+            for (const auto& backend : _available_backends) {
+                if (backend.first == _default_backend) {
+                    default_backend = backend.second;
+                    break;
+                }
+            }
+
+            _decorators.push_back(std::make_unique<RoutingStorageBackend>(storage_config["routes"], _available_backends, default_backend));
+            _router = _decorators.back().get();
+        }
+
         _initialized = true;
         _mtx.unlock();
     }
@@ -67,6 +197,10 @@ namespace Vortex::Core::Storage {
     }
 
     StorageBackendInterface* Storage::get_backend() {
+        if (_initialized && _router != nullptr) {
+            return _router;
+        }
+
         return get_backend(_default_backend);
     }
 
@@ -92,4 +226,8 @@ namespace Vortex::Core::Storage {
         return nullptr;
     }
 
+    ChangeFeed& Storage::change_feed() {
+        return _change_feed;
+    }
+
 }
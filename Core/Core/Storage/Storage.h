@@ -1,10 +1,15 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <boost/asio/thread_pool.hpp>
 #include <Maze/Maze.hpp>
 #include <Core/DLLSupport.h>
+#include <Core/Storage/ChangeFeed.h>
+#include <Core/Storage/Cursor.h>
+#include <Core/Storage/QueryOptions.h>
 
 namespace Vortex::Core::Storage {
 
@@ -20,6 +25,27 @@ namespace Vortex::Core::Storage {
         VORTEX_CORE_API virtual void simple_delete_all(const std::string& database, const std::string& collection, const std::string& json_simple_query) = 0;
         VORTEX_CORE_API virtual void simple_delete_first(const std::string& database, const std::string& collection, const std::string& json_simple_query) = 0;
 
+        // Structured query, default implementations go through the json string methods above
+        VORTEX_CORE_API virtual void insert_document(const std::string& database, const std::string& collection, const Maze::Element& value);
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query);
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query);
+        VORTEX_CORE_API virtual void replace_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& replacement_value);
+        VORTEX_CORE_API virtual void delete_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query);
+        VORTEX_CORE_API virtual void delete_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query);
+
+        // Only the fields selected by the projection ({ "field": 1, ... } or { "field": 0, ... }) are returned.
+        // Default implementations project the complete results of the methods above.
+        VORTEX_CORE_API virtual const std::string simple_find_all(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection);
+        VORTEX_CORE_API virtual const std::string simple_find_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_projection);
+        VORTEX_CORE_API virtual Maze::Element find_all_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection);
+        VORTEX_CORE_API virtual Maze::Element find_first_document(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const Maze::Element& projection);
+
+        // Documents in batches with limit, skip, sort, projection and keyset pagination.
+        // The default implementation applies the options to the results of find_all_documents.
+        VORTEX_CORE_API virtual std::unique_ptr<StorageCursor> find_documents(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options);
+        // First batch of find_documents: { "documents": [...], "next": options of the next page or null }
+        VORTEX_CORE_API Maze::Element find_page(const std::string& database, const std::string& collection, const Maze::Element& simple_query, const QueryOptions& options);
+
         // Basic CRUD methods
         // virtual void insert(std::string database, std::string collection, std::string value) = 0;
         // virtual std::string find(std::string database, std::string collection, std::string query) = 0;
@@ -31,6 +57,11 @@ namespace Vortex::Core::Storage {
 
         VORTEX_CORE_API virtual bool database_exists(const std::string& database) = 0;
         VORTEX_CORE_API virtual bool collection_exists(const std::string& database, const std::string& collection) = 0;
+
+        // Runs the blocking calls of the async_* functions in AsyncStorage.h, shared by all backends by default
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool();
+        // Pool for calls on one collection, differs from blocking_pool() when the collection is served by another backend
+        VORTEX_CORE_API virtual boost::asio::thread_pool& blocking_pool_for(const std::string& database, const std::string& collection);
     };
 
 
@@ -49,15 +80,23 @@ namespace Vortex::Core::Storage {
         VORTEX_CORE_API void initialize(const Maze::Element& storage_config);
         VORTEX_CORE_API const bool is_initialized() const;
 
+        // Backend of the routes when they are configured, otherwise the default backend
         VORTEX_CORE_API StorageBackendInterface* get_backend();
         VORTEX_CORE_API StorageBackendInterface* get_backend(const std::string& backend_name);
 
+        VORTEX_CORE_API ChangeFeed& change_feed();
+
     private:
         std::vector<std::pair<std::string, StorageBackendInterface*>> _available_backends;
         std::string _default_backend;
         Maze::Element _storage_config;
         bool _initialized = false;
         std::mutex _mtx;
+        ChangeFeed _change_feed;
+        // Decorators (like CachingStorageBackend) which replaced backends in _available_backends, destroyed before the change feed they subscribe to
+        std::vector<std::unique_ptr<StorageBackendInterface>> _decorators;
+        // Set when storage.routes spreads collections across backends, returned by get_backend()
+        StorageBackendInterface* _router = nullptr;
     };
 
 }  // namespace Vortex::Core::Storage
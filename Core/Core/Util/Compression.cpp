@@ -0,0 +1,80 @@
+#include <Core/Util/Compression.h>
+#include <cstdint>
+#include <stdexcept>
+#ifdef HAS_FEATURE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace Vortex::Core::Util {
+
+    namespace {
+
+        const std::string marker("\0VZ1", 4);
+        const size_t header_length = 8;
+
+    }  // namespace
+
+    bool Compression::is_available() {
+#ifdef HAS_FEATURE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool Compression::is_compressed(const std::string& value) {
+        return value.length() >= header_length && value.compare(0, marker.length(), marker) == 0;
+    }
+
+    std::string Compression::compress(const std::string& value, int level) {
+#ifdef HAS_FEATURE_ZLIB
+        uLongf compressed_length = compressBound((uLong)value.length());
+
+        std::string output(header_length + compressed_length, '\0');
+        output.replace(0, marker.length(), marker);
+
+        const uint32_t original_length = (uint32_t)value.length();
+        for (int i = 0; i < 4; ++i) {
+            output[marker.length() + i] = (char)((original_length >> ((3 - i) * 8)) & 0xff);
+        }
+
+        if (compress2((Bytef*)&output[header_length], &compressed_length,
+            (const Bytef*)value.data(), (uLong)value.length(), level) != Z_OK) {
+            throw std::runtime_error("Unable to compress value");
+        }
+
+        output.resize(header_length + compressed_length);
+
+        return output;
+#else
+        return value;
+#endif
+    }
+
+    std::string Compression::decompress(const std::string& value) {
+        if (!is_compressed(value)) {
+            return value;
+        }
+
+#ifdef HAS_FEATURE_ZLIB
+        uint32_t original_length = 0;
+        for (int i = 0; i < 4; ++i) {
+            original_length = (original_length << 8) | (unsigned char)value[marker.length() + i];
+        }
+
+        std::string output(original_length, '\0');
+        uLongf output_length = original_length;
+
+        if (uncompress((Bytef*)&output[0], &output_length,
+            (const Bytef*)value.data() + header_length, (uLong)(value.length() - header_length)) != Z_OK ||
+            output_length != original_length) {
+            throw std::runtime_error("Unable to decompress value");
+        }
+
+        return output;
+#else
+        throw std::runtime_error("Compressed value can not be read, zlib support is not enabled");
+#endif
+    }
+
+}
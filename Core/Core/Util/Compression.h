@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Util::Compression {
+
+    // Compressed values start with a "\0VZ1" marker followed by the original length
+    VORTEX_CORE_API bool is_available();
+    VORTEX_CORE_API bool is_compressed(const std::string& value);
+
+    VORTEX_CORE_API std::string compress(const std::string& value, int level = 6);
+    VORTEX_CORE_API std::string decompress(const std::string& value);
+
+}  // namespace Vortex::Core::Util::Compression
@@ -0,0 +1,260 @@
+#include <Core/Util/MessagePack.h>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace Vortex::Core::Util {
+
+    namespace {
+
+        const unsigned char marker = 0xc1;
+
+        void write_big_endian(std::string& output, uint64_t value, int bytes) {
+            for (int i = bytes - 1; i >= 0; --i) {
+                output.push_back((char)((value >> (i * 8)) & 0xff));
+            }
+        }
+
+        void write_length(std::string& output, size_t length, unsigned char fix_prefix, size_t fix_max,
+            unsigned char prefix_8, unsigned char prefix_16, unsigned char prefix_32) {
+            if (length <= fix_max) {
+                output.push_back((char)(fix_prefix | length));
+            }
+            else if (prefix_8 != 0 && length <= 0xff) {
+                output.push_back((char)prefix_8);
+                write_big_endian(output, length, 1);
+            }
+            else if (length <= 0xffff) {
+                output.push_back((char)prefix_16);
+                write_big_endian(output, length, 2);
+            }
+            else {
+                output.push_back((char)prefix_32);
+                write_big_endian(output, length, 4);
+            }
+        }
+
+        void encode_element(std::string& output, const Maze::Element& value) {
+            switch (value.get_type()) {
+            case Maze::Type::Bool:
+                output.push_back((char)(value.get_bool() ? 0xc3 : 0xc2));
+                break;
+            case Maze::Type::Int: {
+                int int_value = value.get_int();
+
+                if (int_value >= -32 && int_value <= 127) {
+                    output.push_back((char)int_value);
+                }
+                else {
+                    output.push_back((char)0xd2);
+                    write_big_endian(output, (uint32_t)int_value, 4);
+                }
+                break;
+            }
+            case Maze::Type::Double: {
+                double double_value = value.get_double();
+                uint64_t bits;
+                std::memcpy(&bits, &double_value, sizeof(bits));
+
+                output.push_back((char)0xcb);
+                write_big_endian(output, bits, 8);
+                break;
+            }
+            case Maze::Type::String: {
+                const std::string& string_value = value.get_string();
+
+                write_length(output, string_value.length(), 0xa0, 31, 0xd9, 0xda, 0xdb);
+                output.append(string_value);
+                break;
+            }
+            case Maze::Type::Array:
+                write_length(output, value.count_children(), 0x90, 15, 0, 0xdc, 0xdd);
+
+                for (const auto& child : value) {
+                    encode_element(output, child);
+                }
+                break;
+            case Maze::Type::Object: {
+                write_length(output, value.count_children(), 0x80, 15, 0, 0xde, 0xdf);
+
+                auto child_it = value.begin();
+                for (auto key_it = value.keys_begin(); key_it != value.keys_end(); ++key_it, ++child_it) {
+                    write_length(output, key_it->length(), 0xa0, 31, 0xd9, 0xda, 0xdb);
+                    output.append(*key_it);
+                    encode_element(output, *child_it);
+                }
+                break;
+            }
+            default:
+                output.push_back((char)0xc0);
+                break;
+            }
+        }
+
+
+        class Decoder {
+        public:
+            Decoder(const std::string& value)
+                : _data((const unsigned char*)value.data()), _length(value.length()) {}
+
+            Maze::Element decode_all() {
+                if (_length == 0 || _data[0] != marker) {
+                    throw std::runtime_error("Value is not MessagePack encoded");
+                }
+                _position = 1;
+
+                Maze::Element result = decode_element();
+
+                if (_position != _length) {
+                    throw std::runtime_error("Unexpected data after MessagePack value");
+                }
+
+                return result;
+            }
+
+        private:
+            const unsigned char* _data;
+            size_t _length;
+            size_t _position = 0;
+
+            void require(size_t bytes) {
+                if (_length - _position < bytes) {
+                    throw std::runtime_error("Truncated MessagePack value");
+                }
+            }
+
+            uint64_t read_big_endian(int bytes) {
+                require(bytes);
+
+                uint64_t value = 0;
+                for (int i = 0; i < bytes; ++i) {
+                    value = (value << 8) | _data[_position++];
+                }
+
+                return value;
+            }
+
+            Maze::Element read_integer(int64_t value) {
+                if (value >= INT32_MIN && value <= INT32_MAX) {
+                    return Maze::Element((int)value);
+                }
+
+                // Maze integers are 32-bit, larger values are kept as doubles
+                return Maze::Element((double)value);
+            }
+
+            std::string read_string(size_t length) {
+                require(length);
+
+                std::string value((const char*)_data + _position, length);
+                _position += length;
+
+                return value;
+            }
+
+            Maze::Element read_array(size_t count) {
+                Maze::Element array(Maze::Type::Array);
+
+                for (size_t i = 0; i < count; ++i) {
+                    array.push_back(decode_element());
+                }
+
+                return array;
+            }
+
+            Maze::Element read_object(size_t count) {
+                Maze::Element object(Maze::Type::Object);
+
+                for (size_t i = 0; i < count; ++i) {
+                    Maze::Element key = decode_element();
+                    if (!key.is_string()) {
+                        throw std::runtime_error("MessagePack map keys must be strings");
+                    }
+
+                    object.set(key.get_string(), decode_element());
+                }
+
+                return object;
+            }
+
+            Maze::Element decode_element() {
+                require(1);
+                unsigned char type = _data[_position++];
+
+                if (type <= 0x7f) {
+                    return Maze::Element((int)type);
+                }
+                if (type >= 0xe0) {
+                    return Maze::Element((int)(int8_t)type);
+                }
+                if ((type & 0xe0) == 0xa0) {
+                    return Maze::Element(read_string(type & 0x1f));
+                }
+                if ((type & 0xf0) == 0x90) {
+                    return read_array(type & 0x0f);
+                }
+                if ((type & 0xf0) == 0x80) {
+                    return read_object(type & 0x0f);
+                }
+
+                switch (type) {
+                case 0xc0: return Maze::Element::get_null_element();
+                case 0xc2: return Maze::Element(false);
+                case 0xc3: return Maze::Element(true);
+                case 0xca: {
+                    uint32_t bits = (uint32_t)read_big_endian(4);
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return Maze::Element((double)value);
+                }
+                case 0xcb: {
+                    uint64_t bits = read_big_endian(8);
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return Maze::Element(value);
+                }
+                case 0xcc: return read_integer((int64_t)read_big_endian(1));
+                case 0xcd: return read_integer((int64_t)read_big_endian(2));
+                case 0xce: return read_integer((int64_t)read_big_endian(4));
+                case 0xcf: {
+                    uint64_t value = read_big_endian(8);
+                    return value <= INT32_MAX ? Maze::Element((int)value) : Maze::Element((double)value);
+                }
+                case 0xd0: return read_integer((int8_t)read_big_endian(1));
+                case 0xd1: return read_integer((int16_t)read_big_endian(2));
+                case 0xd2: return read_integer((int32_t)read_big_endian(4));
+                case 0xd3: return read_integer((int64_t)read_big_endian(8));
+                case 0xd9: return Maze::Element(read_string(read_big_endian(1)));
+                case 0xda: return Maze::Element(read_string(read_big_endian(2)));
+                case 0xdb: return Maze::Element(read_string(read_big_endian(4)));
+                case 0xdc: return read_array(read_big_endian(2));
+                case 0xdd: return read_array(read_big_endian(4));
+                case 0xde: return read_object(read_big_endian(2));
+                case 0xdf: return read_object(read_big_endian(4));
+                default:
+                    throw std::runtime_error("Unsupported MessagePack type");
+                }
+            }
+        };
+
+    }  // namespace
+
+    std::string MessagePack::encode(const Maze::Element& value) {
+        std::string output;
+        output.reserve(256);
+        output.push_back((char)marker);
+
+        encode_element(output, value);
+
+        return output;
+    }
+
+    Maze::Element MessagePack::decode(const std::string& value) {
+        return Decoder(value).decode_all();
+    }
+
+    bool MessagePack::is_encoded(const std::string& value) {
+        return !value.empty() && (unsigned char)value[0] == marker;
+    }
+
+}
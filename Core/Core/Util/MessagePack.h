@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <Maze/Maze.hpp>
+#include <Core/DLLSupport.h>
+
+namespace Vortex::Core::Util::MessagePack {
+
+    // Values are prefixed with 0xc1 (never used by MessagePack) so they can be told apart from json text
+    VORTEX_CORE_API std::string encode(const Maze::Element& value);
+    VORTEX_CORE_API Maze::Element decode(const std::string& value);
+    VORTEX_CORE_API bool is_encoded(const std::string& value);
+
+}  // namespace Vortex::Core::Util::MessagePack
@@ -1,4 +1,5 @@
 #include <Core/Util/Time.h>
+#include <chrono>
 #include <time.h>
 
 namespace Vortex::Core::Util {
@@ -6,6 +7,11 @@ namespace Vortex::Core::Util {
         return (int)::time(nullptr);
     }
 
+    long long Time::get_now_millis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>
+            (std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
     int Time::get_diff(const int time) {
         return get_diff(get_now(), time);
     }
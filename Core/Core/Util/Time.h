@@ -6,6 +6,7 @@
 namespace Vortex::Core::Util::Time {
 
     VORTEX_CORE_API int get_now();
+    VORTEX_CORE_API long long get_now_millis();
     VORTEX_CORE_API int get_diff(const int time);
     VORTEX_CORE_API int get_diff(const int time_1, const int time_2);
     VORTEX_CORE_API const std::string to_string(const int time);
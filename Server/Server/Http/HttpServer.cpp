@@ -1,10 +1,12 @@
 #include <Server/Http/HttpServer.h>
+#include <mutex>
 #include <thread>
 #include <boost/asio/ip/address.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <Server/Http/HttpListener.h>
 #include <Core/GlobalRuntime.h>
+#include <Core/Caching/CacheWarmup.h>
 #include <Core/Logging.h>
 
 using std::string;
@@ -32,6 +34,24 @@ namespace Vortex::Server::Http {
             return;
         }
 
+        if (Core::Caching::CacheWarmup::is_enabled(config)) {
+            // Cache is shared by all servers in the process so it only needs to be warmed up once
+            static std::once_flag warmup_flag;
+
+            std::call_once(warmup_flag, [&config]() {
+                VORTEX_INFO("Warming up cache...");
+
+                try {
+                    Core::Caching::CacheWarmupResult result = Core::Caching::CacheWarmup(config).run();
+
+                    VORTEX_INFO("Cache warm-up finished in {0} ms. Loaded {1} entries.", result.duration_millis, result.loaded_entries);
+                }
+                catch (const std::exception& e) {
+                    VORTEX_ERROR("Cache warm-up failed - {0}", e.what());
+                }
+                });
+        }
+
         Maze::Element server_config(Maze::Type::Object);
         if (_config.is_object("server")) {
             server_config = _config.get("server");
@@ -4,8 +4,9 @@
 #include <Core/Modules/DependencyInjection.h>
 #include <Core/Exceptions/VortexException.h>
 #include <Core/Exceptions/ExitFrameworkException.h>
+#include <Core/GlobalRuntime.h>
 #include <Core/Logging.h>
-#ifdef HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
 #include <mongocxx/exception/exception.hpp>
 #endif
 
@@ -65,6 +66,10 @@ namespace Vortex::Server::Http {
         _res.set(boost::beast::http::field::content_type, "text/html");
         _res.result(boost::beast::http::status::ok);
 
+        if (is_metrics_request()) {
+            return send_metrics();
+        }
+
         std::shared_ptr<Vortex::Core::RuntimeInterface> framework;
 
         try {
@@ -84,7 +89,7 @@ namespace Vortex::Server::Http {
         }
         catch (int) {
 
-#ifdef HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         }
         catch (const mongocxx::exception& e) {
             _res.result(boost::beast::http::status::internal_server_error);
@@ -159,4 +164,48 @@ namespace Vortex::Server::Http {
             _res.need_eof()));
     }
 
+    bool HttpSession::is_metrics_request() const {
+        const Maze::Element& server_config = _config.get_const_ref("server", Maze::Type::Object);
+
+        return server_config.is_string("metrics_path") &&
+            _req.method() == beast::http::verb::get &&
+            _req.target() == server_config["metrics_path"].get_string();
+    }
+
+    bool HttpSession::is_metrics_authorized() const {
+        const Maze::Element& server_config = _config.get_const_ref("server", Maze::Type::Object);
+
+        if (server_config.is_string("metrics_token") && !server_config["metrics_token"].get_string().empty()) {
+            const auto& authorization = _req.find(beast::http::field::authorization);
+
+            return authorization != _req.end() &&
+                authorization->value() == "Bearer " + server_config["metrics_token"].get_string();
+        }
+
+        // Without a token the metrics are only served to local clients
+        error_code ec;
+        const asio::ip::address address = _stream.socket().remote_endpoint(ec).address();
+
+        return !ec && address.is_loopback();
+    }
+
+    void HttpSession::send_metrics() {
+        if (!is_metrics_authorized()) {
+            _res.result(beast::http::status::forbidden);
+            _res.body() = "Forbidden";
+            _res.set(boost::beast::http::field::content_length, _res.body().size());
+
+            return send();
+        }
+
+        Maze::Element metrics(Maze::Type::Object);
+        metrics.set("cache", Core::GlobalRuntime::instance().cache().statistics().snapshot());
+
+        _res.set(boost::beast::http::field::content_type, "application/json");
+        _res.body() = metrics.to_json();
+        _res.set(boost::beast::http::field::content_length, _res.body().size());
+
+        send();
+    }
+
 }
@@ -29,6 +29,11 @@ namespace Vortex::Server::Http {
 		void send();
 
 	private:
+		bool is_metrics_request() const;
+		// metrics_token has to be sent as a bearer token when configured, otherwise only loopback clients are allowed
+		bool is_metrics_authorized() const;
+		void send_metrics();
+
 		boost::beast::tcp_stream _stream;
 		boost::beast::flat_buffer _buffer;
 		boost::beast::http::request<boost::beast::http::string_body> _req;
@@ -0,0 +1,110 @@
+#include <Test.h>
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <Maze/Maze.hpp>
+#include <Core/GlobalRuntime.h>
+#include <Core/Storage/Filesystem/FilesystemBackend.h>
+
+using namespace Vortex::Core;
+
+namespace {
+
+    const int writer_count = 4;
+    const int reader_count = 4;
+    const int inserts_per_writer = 250;
+
+    // Inserts from several threads while others read, every insert has to survive and readers must never
+    // see the collection shrink (a stale cached read stored after a write would make it look like that)
+    void run_scenario(const std::string& name, const Maze::Element& filesystem_config) {
+        Storage::Filesystem::FilesystemBackend backend;
+        backend.set_config(filesystem_config);
+
+        std::atomic<bool> writing{ true };
+        std::vector<std::thread> threads;
+
+        for (int writer = 0; writer < writer_count; ++writer) {
+            threads.emplace_back([&backend, writer]() {
+                for (int i = 0; i < inserts_per_writer; ++i) {
+                    backend.insert_document("stress", "documents",
+                        Maze::Element({ "writer", "index" }, { Maze::Element(writer), Maze::Element(i) }));
+                }
+                });
+        }
+
+        for (int reader = 0; reader < reader_count; ++reader) {
+            threads.emplace_back([&backend, &writing, &name]() {
+                int last_count = 0;
+
+                while (writing) {
+                    const int count = backend.find_all_documents("stress", "documents", Maze::Element(Maze::Type::Object)).count_children();
+
+                    Tests::check(count >= last_count, name + ": read " + std::to_string(count) +
+                        " documents after already reading " + std::to_string(last_count));
+                    last_count = count;
+                }
+                });
+        }
+
+        for (int writer = 0; writer < writer_count; ++writer) {
+            threads[writer].join();
+        }
+
+        writing = false;
+
+        for (size_t i = writer_count; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+
+        const Maze::Element documents = backend.find_all_documents("stress", "documents", Maze::Element(Maze::Type::Object));
+        Tests::check(documents.count_children() == writer_count * inserts_per_writer,
+            name + ": expected " + std::to_string(writer_count * inserts_per_writer) + " documents, found " + std::to_string(documents.count_children()));
+
+        std::set<std::pair<int, int>> inserted;
+        for (const auto& document : documents) {
+            inserted.emplace(document["writer"].get_int(), document["index"].get_int());
+        }
+
+        Tests::check((int)inserted.size() == writer_count * inserts_per_writer, name + ": documents were lost or duplicated");
+    }
+
+    Maze::Element make_config(const std::string& root_path, bool resident_collections, bool write_log) {
+        Maze::Element config({ "root_path", "cache_enabled", "cache_expiry", "resident_collections", "watch_changes" }, {
+            Maze::Element(root_path), Maze::Element(true), Maze::Element(60), Maze::Element(resident_collections), Maze::Element(false) });
+
+        config.set("write_log", Maze::Element({ "enabled" }, { Maze::Element(write_log) }));
+        config.set("durability", Maze::Element({ "fsync" }, { Maze::Element("never") }));
+
+        return config;
+    }
+
+}  // namespace
+
+int main(int argc, char** args) {
+    Maze::Element cache_config({ "enabled" }, { Maze::Element(true) });
+    cache_config.set("config", Maze::Element({ "MemoryCache" }, { Maze::Element({ "enabled" }, { Maze::Element(true) }) }));
+    GlobalRuntime::instance().cache().initialize(cache_config);
+
+    const boost::filesystem::path root = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vortex-test-%%%%-%%%%");
+
+    struct { const char* name; bool resident_collections; bool write_log; } scenarios[] = {
+        { "cached contents", false, false },
+        { "resident collections", true, false },
+        { "write log", false, true }
+    };
+
+    for (const auto& scenario : scenarios) {
+        const boost::filesystem::path scenario_root = root / scenario.name;
+        boost::filesystem::create_directories(scenario_root / "stress");
+
+        run_scenario(scenario.name, make_config(scenario_root.string(), scenario.resident_collections, scenario.write_log));
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(root, ec);
+
+    return Tests::result();
+}
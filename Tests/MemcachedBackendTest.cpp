@@ -0,0 +1,89 @@
+#include <Test.h>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+#include <Maze/Maze.hpp>
+#include <Core/Caching/Backends/MemcachedBackend.h>
+#include <Core/Util/Time.h>
+
+using namespace Vortex::Core::Caching::Backends;
+
+namespace {
+
+    Maze::Element make_config(const std::string& server) {
+        Maze::Element servers(Maze::Type::Array);
+        servers.push_back(Maze::Element(server));
+
+        return Maze::Element({ "enabled", "servers", "timeout_ms", "retry_ms" }, {
+            Maze::Element(true), servers, Maze::Element(500), Maze::Element(100) });
+    }
+
+}  // namespace
+
+// Runs against a memcached server started locally, e.g. `memcached -p 11211` and VORTEX_TEST_MEMCACHED=127.0.0.1:11211
+int main(int argc, char** args) {
+    const char* server = std::getenv("VORTEX_TEST_MEMCACHED");
+    if (server == nullptr || *server == '\0') {
+        printf("VORTEX_TEST_MEMCACHED is not set, skipping\n");
+
+        return Tests::skipped;
+    }
+
+    MemcachedBackend backend(make_config(server));
+    backend.connect();
+
+    // Keys of earlier runs must not satisfy the checks
+    const std::string prefix = "vortex.test." + std::to_string(Vortex::Core::Util::Time::get_now_millis()) + ".";
+
+    // Values
+    backend.set(prefix + "value", "contents", 60);
+    Tests::check(backend.get(prefix + "value") == "contents", "stored value is returned");
+    Tests::check(backend.exists(prefix + "value"), "stored value exists");
+
+    backend.set(prefix + "value", std::string(100000, 'x'), 60);
+    Tests::check(backend.get(prefix + "value") == std::string(100000, 'x'), "large value replaces the previous one");
+
+    backend.remove(prefix + "value");
+    Tests::check(backend.get(prefix + "value").empty(), "removed value is missing");
+    Tests::check(!backend.exists(prefix + "value"), "removed value doesn't exist");
+
+    // Expiry, memcached counts in whole seconds
+    backend.set(prefix + "expiring", "contents", 1);
+    backend.set(prefix + "touched", "contents", 60);
+    backend.set_expiry(prefix + "touched", 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    Tests::check(!backend.exists(prefix + "expiring"), "value expires");
+    Tests::check(!backend.exists(prefix + "touched"), "value expires after its expiry was changed");
+
+    // Tags
+    backend.set_tagged(prefix + "tagged", "contents", 60, { prefix + "tag" });
+    backend.set_tagged(prefix + "other", "contents", 60, { prefix + "other_tag" });
+    Tests::check(backend.get(prefix + "tagged") == "contents", "tagged value is returned");
+
+    backend.invalidate_tag(prefix + "tag");
+    Tests::check(!backend.exists(prefix + "tagged"), "value of an invalidated tag is missing");
+    Tests::check(backend.get(prefix + "other") == "contents", "values of other tags are kept");
+
+    backend.set_tagged(prefix + "tagged", "renewed", 60, { prefix + "tag" });
+    Tests::check(backend.get(prefix + "tagged") == "renewed", "value stored after the invalidation is returned");
+
+    // Multi get
+    backend.set(prefix + "a", "1", 60);
+    backend.set(prefix + "b", "2", 60);
+    const std::map<std::string, std::string> values = backend.get_multi({ prefix + "a", prefix + "b", prefix + "missing", prefix + "tagged" });
+    Tests::check(values.size() == 3, "multi get returns only the existing values");
+    Tests::check(values.count(prefix + "a") && values.at(prefix + "a") == "1", "multi get returns the first value");
+    Tests::check(values.count(prefix + "b") && values.at(prefix + "b") == "2", "multi get returns the second value");
+    Tests::check(values.count(prefix + "tagged") && values.at(prefix + "tagged") == "renewed", "multi get returns tagged values");
+
+    // Unreachable servers behave like an empty cache instead of failing the caller
+    MemcachedBackend unreachable_backend(make_config("127.0.0.1:1"));
+    unreachable_backend.connect();
+    unreachable_backend.set(prefix + "value", "contents", 60);
+    Tests::check(unreachable_backend.get(prefix + "value").empty(), "unreachable server misses");
+    Tests::check(unreachable_backend.get_multi({ prefix + "a" }).empty(), "unreachable server misses on multi get");
+
+    return Tests::result();
+}
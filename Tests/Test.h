@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+namespace Tests {
+
+    // Exit code which makes ctest report the test as skipped
+    const int skipped = 77;
+
+    inline std::atomic<int>& failures() {
+        static std::atomic<int> count{ 0 };
+
+        return count;
+    }
+
+    // Records a failure instead of aborting, so threads of a stress test can keep checking
+    inline bool check(bool condition, const std::string& message) {
+        if (!condition) {
+            fprintf(stderr, "FAILED: %s\n", message.c_str());
+            ++failures();
+        }
+
+        return condition;
+    }
+
+    inline int result() {
+        if (failures() > 0) {
+            fprintf(stderr, "%d check(s) failed\n", failures().load());
+
+            return 1;
+        }
+
+        printf("All checks passed\n");
+
+        return 0;
+    }
+
+}  // namespace Tests
@@ -0,0 +1,7 @@
+#
+# Set tests that need to be built, each one is built from <name>.cpp
+#
+set(TEST_NAMES
+    FilesystemConcurrencyTest
+    MemcachedBackendTest
+)
@@ -1,12 +1,30 @@
 #include <VortexBase/Application.h>
+#include <algorithm>
+#include <future>
+#include <boost/asio/use_future.hpp>
 #include <Core/GlobalRuntime.h>
 #include <Core/Modules/DependencyInjection.h>
+#include <Core/Storage/AsyncStorage.h>
 
 using Vortex::Core::RuntimeInterface;
 using Vortex::Core::GlobalRuntime;
+using Vortex::Core::Caching::Cache;
 
 namespace VortexBase {
 
+    namespace {
+
+        std::string get_locations_cache_key(const std::string& collection, const std::vector<std::string>& databases) {
+            std::string cache_key = "vortex.core.application.locations." + collection;
+            for (const auto& database : databases) {
+                cache_key += "." + database;
+            }
+
+            return cache_key;
+        }
+
+    }  // namespace
+
     Application::Application(RuntimeInterface* runtime)
         : ApplicationInterface(runtime) {}
 
@@ -16,17 +34,18 @@ namespace VortexBase {
 
         const std::string cache_key = "vortex.core.application.value." + application_id;
         if (GlobalRuntime::instance().cache().exists(cache_key)) {
-            _application = Maze::Element::from_json(GlobalRuntime::instance().cache().get(cache_key));
+            _application = GlobalRuntime::instance().cache().get_element(cache_key);
         }
 
         if (!_application.has_children()) {
             Maze::Element query({ "_id" }, { Maze::Element({"$oid"}, {application_id}) });
 
-            _application = Maze::Element::from_json(GlobalRuntime::instance().storage().get_backend()
-                ->simple_find_first("vortex", "apps", query.to_json()));
+            _application = GlobalRuntime::instance().storage().get_backend()
+                ->find_first_document("vortex", "apps", query);
 
             if (_application.has_children()) {
-                GlobalRuntime::instance().cache().set(cache_key, _application.to_json(0));
+                GlobalRuntime::instance().cache().set_element(cache_key, _application, GlobalRuntime::instance().cache().object_expiry(),
+                    { Cache::collection_tag("vortex", "apps"), Cache::database_tag("vortex"), Cache::application_tag(application_id) });
             }
         }
 
@@ -63,44 +82,133 @@ namespace VortexBase {
         return _application.get("post_script").get_string();
     }
 
-    Maze::Element Application::find_object_in_application_storage(const std::string& collection, const Maze::Element& query, bool search_other_storages) {
-        std::string database;
-        Maze::Element result;
+    std::vector<std::string> Application::storage_databases(bool search_other_storages) {
+        std::vector<std::string> databases;
+
+        // The configured database may be the application id or the shared one, each database is only searched once
+        const auto add_database = [&databases](const std::string& database) {
+            if (std::find(databases.begin(), databases.end(), database) == databases.end()) {
+                databases.push_back(database);
+            }
+        };
 
         if (_runtime->config()->get("application").is_string("database")) {
-            database = _runtime->config()->get("application").get("database").s();
+            add_database(_runtime->config()->get("application").get("database").s());
+        }
 
-            if (GlobalRuntime::instance().storage().get_backend()->collection_exists(database, collection)) {
-                result = Maze::Element::from_json(GlobalRuntime::instance().storage().get_backend()
-                    ->simple_find_first(database, collection, query.to_json()));
+        if (id().length() > 0) {
+            add_database(id());
+        }
 
-                if (result.has_children()) {
-                    return result;
+        if (search_other_storages) {
+            add_database("vortex");
+        }
+
+        return databases;
+    }
+
+    Maze::Element Application::find_object_in_application_storage(const std::string& collection, const Maze::Element& query, bool search_other_storages, const Maze::Element& projection) {
+        const std::vector<std::string> locations = storage_locations(collection, search_other_storages);
+
+        if (locations.empty()) {
+            return Maze::Element();
+        }
+
+        Vortex::Core::Storage::StorageBackendInterface* backend = GlobalRuntime::instance().storage().get_backend();
+        const Cache& cache = GlobalRuntime::instance().cache();
+        const std::vector<std::string> databases = storage_databases(search_other_storages);
+
+        // Location where the same query found its object last time. A change of the collection in any
+        // of the databases invalidates it, so objects added to a higher priority location are not shadowed.
+        const std::string found_cache_key = get_locations_cache_key(collection, databases) + ".found." + query.to_json(0);
+        const std::string found_location = cache.get(found_cache_key);
+
+        const bool has_found_location = !found_location.empty() &&
+            std::find(locations.begin(), locations.end(), found_location) != locations.end();
+
+        // Most lookups are answered by the preferred location alone, the others are only queried when it misses
+        const std::string preferred_location = has_found_location ? found_location : locations[0];
+        Maze::Element result = backend->find_first_document(preferred_location, collection, query, projection);
+        std::string result_location = preferred_location;
+
+        if (!result.has_children()) {
+            std::vector<std::string> fallback_locations;
+            for (const auto& location : locations) {
+                if (location != preferred_location) {
+                    fallback_locations.push_back(location);
                 }
             }
-        }
 
-        if (id().length() > 0) {
-            database = id();
+            // Fallbacks are queried on the storage pool at the same time and taken in lookup order.
+            // Lookups after the first hit are not waited for, their results are dropped when they finish.
+            // The runtime needs the object before it can continue, so the request thread blocks on the futures.
+            std::vector<std::future<Maze::Element>> lookups;
+            for (const auto& location : fallback_locations) {
+                lookups.push_back(Vortex::Core::Storage::async_find_first(backend, location, collection, query, projection, boost::asio::use_future));
+            }
 
-            if (GlobalRuntime::instance().storage().get_backend()->collection_exists(database, collection)) {
-                result = Maze::Element::from_json(GlobalRuntime::instance().storage().get_backend()
-                    ->simple_find_first(database, collection, query.to_json()));
+            for (size_t i = 0; i < lookups.size(); ++i) {
+                result = lookups[i].get();
 
                 if (result.has_children()) {
-                    return result;
+                    result_location = fallback_locations[i];
+                    break;
                 }
             }
         }
 
-        if (search_other_storages) {
-            database = "vortex";
+        if (result.has_children() && !(has_found_location && result_location == found_location)) {
+            std::vector<std::string> tags = Cache::collection_tags(databases, collection);
+            if (id().length() > 0) {
+                tags.push_back(Cache::application_tag(id()));
+            }
 
-            result = Maze::Element::from_json(GlobalRuntime::instance().storage().get_backend()
-                ->simple_find_first(database, collection, query.to_json()));
+            cache.set(found_cache_key, result_location, cache.object_expiry(), tags);
         }
 
         return result;
     }
 
+    std::vector<std::string> Application::storage_locations(const std::string& collection, bool search_other_storages) {
+        const std::vector<std::string> databases = storage_databases(search_other_storages);
+        std::vector<std::string> locations;
+
+        const std::string cache_key = get_locations_cache_key(collection, databases);
+
+        if (GlobalRuntime::instance().cache().exists(cache_key)) {
+            Maze::Element cached_locations = GlobalRuntime::instance().cache().get_element(cache_key);
+
+            if (cached_locations.is_array()) {
+                for (int i = 0; i < cached_locations.count_children(); ++i) {
+                    locations.push_back(cached_locations[i].get_string());
+                }
+
+                return locations;
+            }
+        }
+
+        Maze::Element locations_element(Maze::Type::Array);
+
+        for (size_t i = 0; i < databases.size(); ++i) {
+            // The shared vortex database is always queried, others only if they contain the collection
+            bool is_fallback = search_other_storages && databases[i] == "vortex";
+
+            if (!is_fallback && !GlobalRuntime::instance().storage().get_backend()->collection_exists(databases[i], collection)) {
+                continue;
+            }
+
+            locations.push_back(databases[i]);
+            locations_element << Maze::Element(databases[i]);
+        }
+
+        std::vector<std::string> tags = Cache::collection_tags(databases, collection);
+        if (id().length() > 0) {
+            tags.push_back(Cache::application_tag(id()));
+        }
+
+        GlobalRuntime::instance().cache().set_element(cache_key, locations_element, GlobalRuntime::instance().cache().object_expiry(), tags);
+
+        return locations;
+    }
+
 }
@@ -17,9 +17,16 @@ namespace VortexBase {
         VORTEX_CORE_API virtual std::string script() override;
         VORTEX_CORE_API virtual std::string post_script() override;
 
+        VORTEX_CORE_API virtual std::vector<std::string> storage_databases(bool search_other_storages = true) override;
         VORTEX_CORE_API virtual Maze::Element find_object_in_application_storage(
             const std::string& collection, const Maze::Element& query,
-            bool search_other_storages = true) override;
+            bool search_other_storages = true,
+            const Maze::Element& projection = Maze::Element(Maze::Type::Object)) override;
+
+    protected:
+        // Databases of storage_databases which contain the collection, in lookup order.
+        // Cached per application and collection until the collection changes in one of the databases.
+        std::vector<std::string> storage_locations(const std::string& collection, bool search_other_storages);
     };
 
 }  // namespace VortexBase
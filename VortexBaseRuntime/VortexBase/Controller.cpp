@@ -4,6 +4,7 @@
 
 using Vortex::Core::RuntimeInterface;
 using Vortex::Core::GlobalRuntime;
+using Vortex::Core::Caching::Cache;
 
 namespace VortexBase {
 
@@ -16,7 +17,7 @@ namespace VortexBase {
 
         std::string cache_key = "vortex.core.controller.value." + application_id + "." + name + "." + method;
         if (GlobalRuntime::instance().cache().exists(cache_key)) {
-            _controller = Maze::Element::from_json(GlobalRuntime::instance().cache().get(cache_key));
+            _controller = GlobalRuntime::instance().cache().get_element(cache_key);
         }
 
         if (!_controller.has_children()) {
@@ -32,7 +33,10 @@ namespace VortexBase {
             _controller = _runtime->application()->find_object_in_application_storage("controllers", query);
 
             if (_controller.has_children()) {
-                GlobalRuntime::instance().cache().set(cache_key, _controller.to_json(0));
+                std::vector<std::string> tags = Cache::collection_tags(_runtime->application()->storage_databases(), "controllers");
+                tags.push_back(Cache::application_tag(application_id));
+
+                GlobalRuntime::instance().cache().set_element(cache_key, _controller, GlobalRuntime::instance().cache().object_expiry(), tags);
             }
         }
 
@@ -4,6 +4,7 @@
 
 using Vortex::Core::RuntimeInterface;
 using Vortex::Core::GlobalRuntime;
+using Vortex::Core::Caching::Cache;
 
 namespace VortexBase {
 
@@ -16,15 +17,16 @@ namespace VortexBase {
 
 		std::string cache_key = "vortex.core.host.value." + hostname;
 		if (GlobalRuntime::instance().cache().exists(cache_key)) {
-			_host = Maze::Element::from_json(GlobalRuntime::instance().cache().get(cache_key));
+			_host = GlobalRuntime::instance().cache().get_element(cache_key);
 		}
 
 		if (!_host.has_children()) {
-			_host = Maze::Element::from_json(GlobalRuntime::instance().storage().get_backend()
-				->simple_find_first("vortex", "hosts", Maze::Element({ "hostname" }, { hostname }).to_json()));
+			_host = GlobalRuntime::instance().storage().get_backend()
+				->find_first_document("vortex", "hosts", Maze::Element({ "hostname" }, { hostname }));
 
 			if (_host.has_children()) {
-				GlobalRuntime::instance().cache().set(cache_key, _host.to_json(0));
+				GlobalRuntime::instance().cache().set_element(cache_key, _host, GlobalRuntime::instance().cache().object_expiry(),
+					{ Cache::collection_tag("vortex", "hosts"), Cache::database_tag("vortex") });
 			}
 		}
 		
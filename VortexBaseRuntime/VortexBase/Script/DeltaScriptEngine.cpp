@@ -140,6 +140,17 @@ namespace VortexBase::Script {
                 )
             );
             }, nullptr);
+        _ctx->add_native_function("function storage.find_page(database, collection, json_simple_query, json_options)", [](DeltaScript::Variable* var, void* data) {
+            var->find_child("return")->var->set_string(
+                Vortex::Core::GlobalRuntime::instance().storage().get_backend()
+                ->find_page(
+                    var->find_child("database")->var->get_string(),
+                    var->find_child("collection")->var->get_string(),
+                    Maze::Element::from_json(var->find_child("json_simple_query")->var->get_string()),
+                    Vortex::Core::Storage::QueryOptions::from_element(Maze::Element::from_json(var->find_child("json_options")->var->get_string()))
+                ).to_json()
+            );
+            }, nullptr);
         _ctx->add_native_function("function storage.simple_replace_first(database, collection, json_simple_query, replacement_json_value)", [](DeltaScript::Variable* var, void* data) {
             Vortex::Core::GlobalRuntime::instance().storage().get_backend()
                 ->simple_replace_first(
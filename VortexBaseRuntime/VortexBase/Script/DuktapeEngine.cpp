@@ -177,6 +177,13 @@ namespace DuktapeBindings {
                 ->simple_find_first(database, collection, json_simple_query);
         }
 
+        // Returns { "documents": [...], "next": options of the next page or null }
+        std::string find_page(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& json_options) {
+            return Vortex::Core::GlobalRuntime::instance().storage().get_backend()
+                ->find_page(database, collection, Maze::Element::from_json(json_simple_query),
+                    Vortex::Core::Storage::QueryOptions::from_element(Maze::Element::from_json(json_options))).to_json();
+        }
+
         void simple_replace_first(const std::string& database, const std::string& collection, const std::string& json_simple_query, const std::string& replacement_json_value) {
             Vortex::Core::GlobalRuntime::instance().storage().get_backend()
                 ->simple_replace_first(database, collection, json_simple_query, replacement_json_value);
@@ -208,6 +215,7 @@ namespace DuktapeBindings {
             i.method("simple_insert", &Storage::simple_insert);
             i.method("simple_find_all", &Storage::simple_find_all);
             i.method("simple_find_first", &Storage::simple_find_first);
+            i.method("find_page", &Storage::find_page);
             i.method("simple_replace_first", &Storage::simple_replace_first);
             i.method("simple_delete_all", &Storage::simple_delete_all);
             i.method("simple_delete_first", &Storage::simple_delete_first);
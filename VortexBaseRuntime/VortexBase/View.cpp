@@ -4,6 +4,7 @@
 
 using Vortex::Core::RuntimeInterface;
 using Vortex::Core::GlobalRuntime;
+using Vortex::Core::Caching::Cache;
 
 namespace VortexBase {
 
@@ -184,7 +185,7 @@ namespace VortexBase {
 
         std::string cache_key = "vortex.core.template.value." + _runtime->application()->id() + "." + name;
         if (GlobalRuntime::instance().cache().exists(cache_key)) {
-            _template = Maze::Element::from_json(GlobalRuntime::instance().cache().get(cache_key));
+            _template = GlobalRuntime::instance().cache().get_element(cache_key);
         }
 
         if (!_template.has_children()) {
@@ -202,7 +203,10 @@ namespace VortexBase {
             }
 
             if (_template.has_children()) {
-                GlobalRuntime::instance().cache().set(cache_key, _template.to_json(0));
+                std::vector<std::string> tags = Cache::collection_tags(_runtime->application()->storage_databases(), "templates");
+                tags.push_back(Cache::application_tag(_runtime->application()->id()));
+
+                GlobalRuntime::instance().cache().set_element(cache_key, _template, GlobalRuntime::instance().cache().object_expiry(), tags);
             }
         }
 
@@ -231,7 +235,7 @@ namespace VortexBase {
 
         std::string cache_key = "vortex.core.page.value." + _runtime->application()->id() + "." + name;
         if (GlobalRuntime::instance().cache().exists(cache_key)) {
-            _page = Maze::Element::from_json(GlobalRuntime::instance().cache().get(cache_key));
+            _page = GlobalRuntime::instance().cache().get_element(cache_key);
         }
 
         if (!_page.has_children()) {
@@ -249,7 +253,10 @@ namespace VortexBase {
             }
 
             if (_page.has_children()) {
-                GlobalRuntime::instance().cache().set(cache_key, _page.to_json(0));
+                std::vector<std::string> tags = Cache::collection_tags(_runtime->application()->storage_databases(), "pages");
+                tags.push_back(Cache::application_tag(_runtime->application()->id()));
+
+                GlobalRuntime::instance().cache().set_element(cache_key, _page, GlobalRuntime::instance().cache().object_expiry(), tags);
             }
         }
 
@@ -5,12 +5,15 @@
 #include <thread>
 #include <Maze/Maze.hpp>
 #include <Server/Http/HttpServer.h>
+#include <Core/GlobalRuntime.h>
 #include <Core/Logging.h>
+#include <Core/Storage/CachingStorageBackend.h>
+#include <Core/Storage/Filesystem/FilesystemBackend.h>
 #include <Core/Util/String.h>
 #include <Core/Modules/DependencyInjection.h>
 #include <Core/Modules/ModuleLoader.h>
 #include <boost/filesystem.hpp>
-#ifdef HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
 #include <mongocxx/instance.hpp>
 #endif
 
@@ -22,7 +25,7 @@ namespace Vortex {
     void start_vortex(std::vector<std::string> args) {
         Core::Logging::Logger::initialize();
 
-#ifdef HAS_FEATURE_MONGO
+#ifdef HAS_FEATURE_MONGOCXX
         mongocxx::instance instance{};
 #endif
 
@@ -196,6 +199,10 @@ namespace Vortex {
             << "    -t=[num]                     Default: 4" << std::endl
             << std::endl
             << "  console        Starts vortex shell in interactive mode" << std::endl
+            << "    cache stats                  Prints cache statistics of the running servers" << std::endl
+            << "    cache stats reset            Resets cache statistics" << std::endl
+            << "    storage convert [database] [collection] [json|jsonl]" << std::endl
+            << "                                 Converts filesystem collection to the given format" << std::endl
             << std::endl
             << "  help           Displays help" << std::endl;
     }
@@ -213,6 +220,16 @@ namespace Vortex {
             else if (str == "start") {
                 start_server();
             }
+            else if (str == "cache stats") {
+                std::cout << Core::GlobalRuntime::instance().cache().statistics().snapshot().to_json() << std::endl;
+            }
+            else if (str == "cache stats reset") {
+                Core::GlobalRuntime::instance().cache().statistics().reset();
+                std::cout << "Cache statistics were reset." << std::endl;
+            }
+            else if (Util::String::starts_with(str, "storage convert ")) {
+                convert_collection(Util::String::split(str, " "));
+            }
             else if (str == "exit" || str == "q" || str == "quit") {
                 std::cout << "Exiting Vortex..." << std::endl;
                 exit(0);
@@ -226,6 +243,40 @@ namespace Vortex {
         }
     }
 
+    void convert_collection(const std::vector<std::string>& command) {
+        if (command.size() != 5 || (command[4] != "json" && command[4] != "jsonl")) {
+            std::cout << "Usage: storage convert [database] [collection] [json|jsonl]" << std::endl;
+            return;
+        }
+
+        Core::Storage::Storage& storage = Core::GlobalRuntime::instance().storage();
+        Core::Storage::StorageBackendInterface* backend = storage.is_initialized() ?
+            storage.get_backend(Core::Storage::Filesystem::filesystem_exports.backend_name) : nullptr;
+
+        // Conversion goes to the filesystem backend itself, cached results are dropped by its change events
+        Core::Storage::CachingStorageBackend* caching_backend = dynamic_cast<Core::Storage::CachingStorageBackend*>(backend);
+        if (caching_backend != nullptr) {
+            backend = caching_backend->get_wrapped_backend();
+        }
+
+        Core::Storage::Filesystem::FilesystemBackend* fs_backend = dynamic_cast<Core::Storage::Filesystem::FilesystemBackend*>(backend);
+
+        if (fs_backend == nullptr) {
+            std::cout << "Filesystem storage is not initialized. Start the server first." << std::endl;
+            return;
+        }
+
+        try {
+            fs_backend->convert_collection(command[2], command[3], (command[4] == "jsonl") ?
+                Core::Storage::Filesystem::FilesystemCollectionFormat::JsonLines : Core::Storage::Filesystem::FilesystemCollectionFormat::Json);
+
+            std::cout << "Collection " << command[2] << "/" << command[3] << " was converted to " << command[4] << "." << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cout << "Unable to convert collection: " << e.what() << std::endl;
+        }
+    }
+
     void start_from_config(const std::string& config_file_name) {
         Maze::Element config(Maze::Type::Object);
 
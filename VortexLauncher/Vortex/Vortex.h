@@ -11,6 +11,7 @@ namespace Vortex {
 	void exit_with_error(int error_code);
 
 	void start_console();
+	void convert_collection(const std::vector<std::string>& command);
 	void start_from_config(const std::string& config_file_name);
 
 	void start_server();
@@ -13,6 +13,11 @@ if (VORTEX_ENABLE_FEATURE_CRYPTOPP)
         PUBLIC HAS_FEATURE_CRYPTOPP=1
     )
 endif()
+if (VORTEX_ENABLE_FEATURE_ZLIB)
+    target_compile_definitions(${PROJECT_NAME}
+        PUBLIC HAS_FEATURE_ZLIB=1
+    )
+endif()
 if (VORTEX_ENABLE_FEATURE_DELTASCRIPT)
     target_compile_definitions(${PROJECT_NAME}
         PUBLIC HAS_FEATURE_DELTASCRIPT=1
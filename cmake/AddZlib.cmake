@@ -0,0 +1,25 @@
+#
+# This scripts adds the zlib library as dependency to the project.
+#
+
+
+#
+# Find the zlib library
+#
+find_package(ZLIB REQUIRED)
+
+
+#
+# Include dependencies into project
+#
+target_link_libraries(${PROJECT_NAME}
+    PUBLIC ZLIB::ZLIB
+)
+
+
+#
+# Add has_feature flag
+#
+target_compile_definitions(${PROJECT_NAME}
+    PUBLIC HAS_FEATURE_ZLIB=1
+)